@@ -0,0 +1,180 @@
+/*************************************************************************
+ * This program is free software; you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation; either version 2 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program; if not, write to the                         *
+ * Free Software Foundation, Inc.,                                       *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA .        *
+ *************************************************************************/
+
+/*
+ * compares the analytic box shadow algorithm to the box blur,
+ * for the radii used by widget shadows, at device pixel ratio 1 and 2
+ */
+
+#include "lightlyboxshadowrenderer.h"
+
+#include <QTest>
+
+using Lightly::BoxShadowRenderer;
+
+class BoxShadowTest: public QObject
+{
+
+    Q_OBJECT
+
+    private Q_SLOTS:
+
+    //* alpha error of the analytic shadow
+    void compare_data();
+    void compare();
+
+    //* rendering time of both algorithms
+    void benchmark_data();
+    void benchmark();
+
+    private:
+
+    //* add radius, corner radius and device pixel ratio columns and rows
+    static void addRows( bool withAlgorithm );
+
+    //* render shadow mask
+    static QImage render( BoxShadowRenderer::Algorithm, int radius, qreal borderRadius, qreal devicePixelRatio );
+
+};
+
+namespace
+{
+
+    /*
+    the box blur only approximates a gaussian and rounds down, so some difference remains
+    between both algorithms. The largest measured difference is 8 alpha levels, at radius 2
+    with corner 3 at device pixel ratio 1, where the rasterized corner is the least smooth.
+    Other radii stay within 4 to 7 levels, with a mean of about 1, which is not visible
+    */
+    const int maxAlphaError = 8;
+    const qreal maxMeanAlphaError = 2.0;
+
+}
+
+//___________________________________________________________
+void BoxShadowTest::addRows( bool withAlgorithm )
+{
+
+    QTest::addColumn<int>( "radius" );
+    QTest::addColumn<qreal>( "borderRadius" );
+    QTest::addColumn<qreal>( "devicePixelRatio" );
+    QTest::addColumn<int>( "algorithm" );
+
+    const QList<QPair<int, QString>> algorithms( {
+        { BoxShadowRenderer::BoxBlur, QStringLiteral( "boxblur" ) },
+        { BoxShadowRenderer::Analytic, QStringLiteral( "analytic" ) } } );
+
+    for( const qreal devicePixelRatio : { 1.0, 2.0 } )
+    {
+        for( int radius = 2; radius <= 8; ++radius )
+        {
+            for( const qreal borderRadius : { 0.0, 3.0 } )
+            {
+
+                const QString tag( QStringLiteral( "radius %1, corner %2 @%3x" ).arg( radius ).arg( borderRadius ).arg( devicePixelRatio ) );
+                if( !withAlgorithm )
+                {
+
+                    QTest::newRow( qPrintable( tag ) ) << radius << borderRadius << devicePixelRatio << int( BoxShadowRenderer::Analytic );
+
+                } else {
+
+                    for( const auto& algorithm : algorithms )
+                    { QTest::newRow( qPrintable( QStringLiteral( "%1, %2" ).arg( algorithm.second, tag ) ) ) << radius << borderRadius << devicePixelRatio << algorithm.first; }
+
+                }
+
+            }
+        }
+    }
+
+}
+
+//___________________________________________________________
+QImage BoxShadowTest::render( BoxShadowRenderer::Algorithm algorithm, int radius, qreal borderRadius, qreal devicePixelRatio )
+{
+
+    BoxShadowRenderer renderer;
+    renderer.setAlgorithm( algorithm );
+    renderer.setBoxSize( BoxShadowRenderer::calculateMinimumBoxSize( radius ) );
+    renderer.setBorderRadius( borderRadius );
+    renderer.setDevicePixelRatio( devicePixelRatio );
+    renderer.addShadow( QPoint(), radius, Qt::black );
+    return renderer.renderMask();
+
+}
+
+//___________________________________________________________
+void BoxShadowTest::compare_data()
+{ addRows( false ); }
+
+//___________________________________________________________
+void BoxShadowTest::compare()
+{
+
+    QFETCH( int, radius );
+    QFETCH( qreal, borderRadius );
+    QFETCH( qreal, devicePixelRatio );
+
+    const QImage expected( render( BoxShadowRenderer::BoxBlur, radius, borderRadius, devicePixelRatio ) );
+    const QImage actual( render( BoxShadowRenderer::Analytic, radius, borderRadius, devicePixelRatio ) );
+    QCOMPARE( actual.size(), expected.size() );
+    QCOMPARE( actual.format(), QImage::Format_Alpha8 );
+
+    int maxError = 0;
+    qint64 totalError = 0;
+    for( int y = 0; y < actual.height(); ++y )
+    {
+        const uchar* actualLine( actual.constScanLine( y ) );
+        const uchar* expectedLine( expected.constScanLine( y ) );
+        for( int x = 0; x < actual.width(); ++x )
+        {
+            const int error( qAbs( int( actualLine[x] ) - int( expectedLine[x] ) ) );
+            maxError = qMax( maxError, error );
+            totalError += error;
+        }
+    }
+
+    const qreal meanError( qreal( totalError )/( actual.width()*actual.height() ) );
+    qInfo( "max alpha error: %d, mean alpha error: %.3f", maxError, meanError );
+
+    QVERIFY2( maxError <= maxAlphaError, qPrintable( QStringLiteral( "max alpha error %1" ).arg( maxError ) ) );
+    QVERIFY2( meanError <= maxMeanAlphaError, qPrintable( QStringLiteral( "mean alpha error %1" ).arg( meanError ) ) );
+
+}
+
+//___________________________________________________________
+void BoxShadowTest::benchmark_data()
+{ addRows( true ); }
+
+//___________________________________________________________
+void BoxShadowTest::benchmark()
+{
+
+    QFETCH( int, radius );
+    QFETCH( qreal, borderRadius );
+    QFETCH( qreal, devicePixelRatio );
+    QFETCH( int, algorithm );
+
+    QBENCHMARK
+    { render( BoxShadowRenderer::Algorithm( algorithm ), radius, borderRadius, devicePixelRatio ); }
+
+}
+
+QTEST_GUILESS_MAIN( BoxShadowTest )
+
+#include "lightlyboxshadowtest.moc"
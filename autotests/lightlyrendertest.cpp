@@ -0,0 +1,460 @@
+/*************************************************************************
+ * This program is free software; you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation; either version 2 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program; if not, write to the                         *
+ * Free Software Foundation, Inc.,                                       *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA .        *
+ *************************************************************************/
+
+/*
+ * rendering regression tests for the lightly style
+ *
+ * cached Helper primitives are compared to their original, uncached implementation, kept below.
+ * The test runs at the device pixel ratio of the application, so it is registered twice,
+ * with QT_SCALE_FACTOR set to 1 and 2.
+ *
+ * LIGHTLY_RENDER_TOLERANCE sets the largest allowed difference per color channel, 4 by default.
+ * Images that do not match are written to the current directory, for inspection.
+ */
+
+#include "lightly.h"
+#include "lightlyanimationdata.h"
+#include "lightlyhelper.h"
+
+#include <QApplication>
+#include <QImage>
+#include <QPainter>
+#include <QPixmap>
+#include <QStandardPaths>
+#include <QTest>
+
+#include <cmath>
+
+namespace
+{
+
+    using namespace Lightly;
+
+    //* transparent pixmap, at the device pixel ratio of the application
+    QPixmap createPixmap( const QSize& size )
+    {
+        const qreal devicePixelRatio( qApp->devicePixelRatio() );
+        QPixmap pixmap( size*devicePixelRatio );
+        pixmap.setDevicePixelRatio( devicePixelRatio );
+        pixmap.fill( Qt::transparent );
+        return pixmap;
+    }
+
+    //* original Helper::topHighlight, rendering into a widget sized pixmap, created at the device pixel ratio
+    void referenceTopHighlight( QPainter* painter, const QRectF& rect, const int radius, const QColor& color )
+    {
+        QPixmap pixmap( createPixmap( QSize( rect.width(), rect.height() ) ) );
+        QPainter p( &pixmap );
+
+        p.setRenderHint( QPainter::Antialiasing );
+
+        p.setPen( Qt::NoPen );
+        p.setBrush( color );
+        p.drawRoundedRect( QRect( 0, 0, rect.width(), rect.height() ), radius, radius );
+
+        p.setCompositionMode(QPainter::CompositionMode_DestinationOut);
+        p.setBrush( Qt::black );
+        p.drawRoundedRect( QRect( 0, 1, rect.width(), rect.height() ), radius, radius );
+        p.end();
+
+        painter->drawPixmap( QRect( rect.x(), rect.y(), rect.width(), rect.height() ), pixmap );
+    }
+
+    /*
+    original Helper::renderLineEdit, with per frame mask and content pixmaps during focus animations,
+    changed where the cached focus ring is meant to look different:
+    - pixmaps are created at the device pixel ratio rather than scaled up
+    - on focus in, the mask is applied at full opacity, so that no faded ring is left outside of the disc
+    */
+    void referenceRenderLineEdit(
+        const Helper& helper, QPainter* painter, const QRect& rect,
+        const QColor& background, const QColor& outline, const bool hasFocus, const bool mouseOver, bool enabled, const bool windowActive, const AnimationMode mode, const qreal opacity )
+    {
+
+        painter->setRenderHint( QPainter::Antialiasing );
+
+        QRectF frameRect( rect.adjusted( Metrics::Frame_FrameWidth, Metrics::Frame_FrameWidth, -Metrics::Frame_FrameWidth, -Metrics::Frame_FrameWidth ) );
+        qreal radius( helper.frameRadius( PenWidth::NoPen, -1 ) );
+
+        painter->setPen( Qt::NoPen );
+        if (enabled)
+        {
+            // draw shadow
+            if( hasFocus )
+            {
+                frameRect.adjust(1, 1, -1, -1);
+                // focus in animation
+                if( mode == 2 && opacity > 0 && opacity < 1) {
+
+                    const qreal finalRadius ((frameRect.width()+Metrics::Frame_FrameWidth)*opacity);
+
+                    QPixmap mask( createPixmap( rect.size() ) );
+
+                    QPainter pmask( &mask );
+                    pmask.setRenderHint( QPainter::Antialiasing );
+                    pmask.fillRect(rect, Qt::black);
+                    pmask.setPen( Qt::NoPen );
+                    pmask.setBrush( Qt::black );
+                    pmask.setCompositionMode(QPainter::CompositionMode_SourceOut);
+                    pmask.drawEllipse(QPointF(frameRect.x(), frameRect.y() + frameRect.height()/2), finalRadius, finalRadius);
+                    pmask.end();
+
+                    QPixmap pixmap( createPixmap( rect.size() ) );
+                    QPainter p( &pixmap );
+                    p.setOpacity(0.3 + 0.7*opacity);
+                    p.setRenderHint( QPainter::Antialiasing );
+                    p.setCompositionMode(QPainter::CompositionMode_SourceOver);
+                    p.setPen(Qt::NoPen);
+                    helper.renderBoxShadow( &p, frameRect, 0, 1, 6, outline.darker(120) , radius, windowActive );
+                    helper.renderBoxShadow( &p, frameRect, 0, 1, 4, outline.darker(130) , radius, windowActive );
+                    helper.renderBoxShadow( &p, frameRect, 0, 1, 4, outline.darker(140) , radius, windowActive );
+                    p.setBrush( helper.alphaColor( outline, 0.6 ) ) ;
+                    QRectF focusFrame = frameRect.adjusted( -2, -2, 2, 2 );
+                    p.drawRoundedRect( focusFrame, radius + 1, radius + 1); // outline around lineedit
+
+                    // mask
+                    p.setOpacity( 1 );
+                    p.setCompositionMode(QPainter::CompositionMode_DestinationOut);
+                    p.drawPixmap(rect, mask);
+                    p.end();
+
+                    painter->drawPixmap( rect, pixmap );
+                }
+
+                // focus animation done
+                else {
+                    helper.renderBoxShadow( painter, frameRect, 0, 1, 7, outline.darker(120) , radius, windowActive );
+                    helper.renderBoxShadow( painter, frameRect, 0, 1, 5, outline.darker(130) , radius, windowActive );
+                    helper.renderBoxShadow( painter, frameRect, 0, 1, 4, outline.darker(140) , radius, windowActive );
+                    painter->setBrush( helper.alphaColor( outline, 0.6 ) ) ;
+                    QRectF focusFrame = frameRect.adjusted( -2, -2, 2, 2 );
+                    painter->drawRoundedRect( focusFrame, radius + 1, radius + 1);
+                }
+            }
+
+            // mouse over or normal state
+            else {
+
+                // focus out animation
+                if( mode == 2 && opacity > 0 && opacity < 1) {
+
+                    const qreal finalRadius ((frameRect.width()+Metrics::Frame_FrameWidth)*opacity);
+
+                    QPixmap mask( createPixmap( rect.size() ) );
+
+                    QPainter pmask( &mask );
+                    pmask.setOpacity(1);
+                    pmask.setRenderHint( QPainter::Antialiasing );
+                    pmask.fillRect(rect, Qt::black);
+                    pmask.setPen( Qt::NoPen );
+                    pmask.setBrush( Qt::black );
+                    pmask.setCompositionMode(QPainter::CompositionMode_SourceOut);
+                    pmask.drawEllipse(QPointF(frameRect.x(), frameRect.y() + frameRect.height()/2), finalRadius, finalRadius);
+                    pmask.end();
+
+                    QPixmap pixmap( createPixmap( rect.size() ) );
+                    QPainter p( &pixmap );
+                    p.setRenderHint( QPainter::Antialiasing );
+                    p.setCompositionMode(QPainter::CompositionMode_SourceOver);
+                    p.setPen(Qt::NoPen);
+                    helper.renderBoxShadow( &p, frameRect, 0, 1, 6, outline.darker(120) , radius, windowActive );
+                    helper.renderBoxShadow( &p, frameRect, 0, 1, 4, outline.darker(120) , radius, windowActive );
+                    p.setBrush( helper.alphaColor( outline, 0.6 ) ) ;
+                    QRectF focusFrame = frameRect.adjusted( -1, -1, 1, 1 );
+                    p.drawRoundedRect( focusFrame, radius + 1, radius + 1);
+
+                    // mask
+                    p.setCompositionMode(QPainter::CompositionMode_DestinationOut);
+                    p.drawPixmap(rect, mask);
+                    p.end();
+
+                    painter->drawPixmap( rect, pixmap );
+
+                    // unfocused lineedit shadow effect
+                    helper.renderBoxShadow( painter, frameRect, 0, 1, 5, QColor(0,0,0,84*(1-opacity)), radius, windowActive );
+                    helper.renderOutline(painter, frameRect, radius, 6*(1-opacity));
+                    painter->setPen( Qt::NoPen );
+
+                }
+
+                // normal or mouse over
+                else {
+                    if ( mouseOver && !hasFocus ) helper.renderBoxShadow( painter, frameRect, 0, 1, 6, QColor(0,0,0,160), radius, windowActive );
+                    else {
+                        helper.renderBoxShadow( painter, frameRect, 0, 1, 5, QColor(0,0,0,84), radius, windowActive );
+                        helper.renderOutline(painter, frameRect, radius, 6);
+                        painter->setPen( Qt::NoPen );
+                    }
+                }
+
+            }
+        }
+
+        // set brush
+        if( background.isValid() ) painter->setBrush( background );
+        else painter->setBrush( Qt::NoBrush );
+
+        if( hasFocus ) radius--;
+
+        // render
+        painter->drawRoundedRect( frameRect, radius, radius );
+    }
+
+    //* circle, the edge of which is not compared
+    struct Circle
+    {
+        QPointF center;
+        qreal radius = -1;
+    };
+
+    //* largest allowed difference per color channel
+    int tolerance()
+    {
+        bool ok( false );
+        const int value( qEnvironmentVariableIntValue( "LIGHTLY_RENDER_TOLERANCE", &ok ) );
+        return ok ? value : 4;
+    }
+
+    //* create transparent image, at the device pixel ratio of the application
+    QImage createImage( const QSize& size )
+    {
+        const qreal devicePixelRatio( qApp->devicePixelRatio() );
+        QImage image( size*devicePixelRatio, QImage::Format_ARGB32_Premultiplied );
+        image.setDevicePixelRatio( devicePixelRatio );
+        image.fill( Qt::transparent );
+        return image;
+    }
+
+    /*
+    largest difference per premultiplied color channel between two images of the same size.
+    Pixels within one logical pixel of the circle edge are skipped
+    */
+    int maxDifference( const QImage& first, const QImage& second, const Circle& ignored )
+    {
+        const qreal devicePixelRatio( first.devicePixelRatio() );
+        int result = 0;
+        for( int y = 0; y < first.height(); ++y )
+        {
+            const QRgb* firstLine( reinterpret_cast<const QRgb*>( first.constScanLine( y ) ) );
+            const QRgb* secondLine( reinterpret_cast<const QRgb*>( second.constScanLine( y ) ) );
+            for( int x = 0; x < first.width(); ++x )
+            {
+                if( ignored.radius >= 0 )
+                {
+                    const QPointF position( QPointF( x + 0.5, y + 0.5 )/devicePixelRatio - ignored.center );
+                    if( std::abs( std::hypot( position.x(), position.y() ) - ignored.radius ) < 1 ) continue;
+                }
+
+                result = qMax( result, qAbs( qRed( firstLine[x] ) - qRed( secondLine[x] ) ) );
+                result = qMax( result, qAbs( qGreen( firstLine[x] ) - qGreen( secondLine[x] ) ) );
+                result = qMax( result, qAbs( qBlue( firstLine[x] ) - qBlue( secondLine[x] ) ) );
+                result = qMax( result, qAbs( qAlpha( firstLine[x] ) - qAlpha( secondLine[x] ) ) );
+            }
+        }
+
+        return result;
+    }
+
+    /*
+    compare images. They are compared premultiplied, since unpremultiplied channels
+    of almost transparent pixels are meaningless. Mismatching images are saved
+    */
+    bool compareImages( const QImage& actual, const QImage& expected, QString& message, const Circle& ignored = Circle() )
+    {
+        const QImage first( actual.convertToFormat( QImage::Format_ARGB32_Premultiplied ) );
+        const QImage second( expected.convertToFormat( QImage::Format_ARGB32_Premultiplied ) );
+        if( first.size() != second.size() )
+        {
+            message = QStringLiteral( "size mismatch: %1x%2 instead of %3x%4" )
+                .arg( first.width() ).arg( first.height() )
+                .arg( second.width() ).arg( second.height() );
+            return false;
+        }
+
+        const int difference( maxDifference( first, second, ignored ) );
+        if( difference <= tolerance() ) return true;
+
+        // file name friendly test tag
+        QString name( QStringLiteral( "%1-%2@%3x" )
+            .arg( QString::fromLatin1( QTest::currentTestFunction() ), QString::fromLatin1( QTest::currentDataTag() ) )
+            .arg( first.devicePixelRatio() ) );
+        name.replace( QLatin1Char( ' ' ), QLatin1Char( '_' ) );
+
+        message = QStringLiteral( "max channel difference %1, tolerance %2" ).arg( difference ).arg( tolerance() );
+        first.save( QStringLiteral( "%1-actual.png" ).arg( name ) );
+        second.save( QStringLiteral( "%1-expected.png" ).arg( name ) );
+        return false;
+    }
+
+}
+
+class RenderTest: public QObject
+{
+
+    Q_OBJECT
+
+    private Q_SLOTS:
+
+    //* create helper
+    void initTestCase();
+
+    //* cleanup
+    void cleanupTestCase();
+
+    //* cached top highlight
+    void topHighlight_data();
+    void topHighlight();
+
+    //* cached focus ring animation
+    void lineEdit_data();
+    void lineEdit();
+
+    private:
+
+    //* helper
+    Helper* _helper = nullptr;
+
+};
+
+//___________________________________________________________
+void RenderTest::initTestCase()
+{
+
+    // do not pick up the user configuration
+    QStandardPaths::setTestModeEnabled( true );
+
+    _helper = new Helper( KSharedConfig::openConfig() );
+    _helper->loadConfig();
+
+}
+
+//___________________________________________________________
+void RenderTest::cleanupTestCase()
+{ delete _helper; }
+
+//___________________________________________________________
+void RenderTest::topHighlight_data()
+{
+
+    QTest::addColumn<QSize>( "size" );
+    QTest::addColumn<int>( "radius" );
+
+    for( const QSize& size : { QSize( 60, 30 ), QSize( 121, 37 ), QSize( 24, 24 ) } )
+    {
+        for( const int radius : { 3, 5 } )
+        {
+            const QString tag( QStringLiteral( "%1x%2 radius %3" ).arg( size.width() ).arg( size.height() ).arg( radius ) );
+            QTest::newRow( qPrintable( tag ) ) << size << radius;
+        }
+    }
+
+}
+
+//___________________________________________________________
+void RenderTest::topHighlight()
+{
+
+    QFETCH( QSize, size );
+    QFETCH( int, radius );
+
+    const QRectF rect( QPointF( 4, 4 ), size );
+    const QSize imageSize( size + QSize( 8, 8 ) );
+
+    QImage actual( createImage( imageSize ) );
+    {
+        QPainter painter( &actual );
+        _helper->topHighlight( &painter, rect, radius );
+    }
+
+    QImage expected( createImage( imageSize ) );
+    {
+        QPainter painter( &expected );
+        referenceTopHighlight( &painter, rect, radius, QColor( 255, 255, 255, 20 ) );
+    }
+
+    QString message;
+    QVERIFY2( compareImages( actual, expected, message ), qPrintable( message ) );
+
+}
+
+//___________________________________________________________
+void RenderTest::lineEdit_data()
+{
+
+    QTest::addColumn<bool>( "hasFocus" );
+    QTest::addColumn<int>( "mode" );
+    QTest::addColumn<qreal>( "opacity" );
+
+    for( const bool hasFocus : { true, false } )
+    {
+        const QString focus( hasFocus ? QStringLiteral( "focus in" ) : QStringLiteral( "focus out" ) );
+
+        // static states
+        QTest::newRow( qPrintable( focus ) ) << hasFocus << int( AnimationNone ) << qreal( AnimationData::OpacityInvalid );
+
+        // animation frames
+        for( const qreal opacity : { 0.1, 0.25, 0.5, 0.75, 0.9 } )
+        { QTest::newRow( qPrintable( QStringLiteral( "%1 %2" ).arg( focus ).arg( opacity ) ) ) << hasFocus << int( AnimationFocus ) << opacity; }
+    }
+
+}
+
+//___________________________________________________________
+void RenderTest::lineEdit()
+{
+
+    QFETCH( bool, hasFocus );
+    QFETCH( int, mode );
+    QFETCH( qreal, opacity );
+
+    const QRect rect( 0, 0, 160, 34 );
+    const QColor background( Qt::white );
+    const QColor outline( 61, 174, 233 );
+
+    QImage actual( createImage( rect.size() ) );
+    {
+        QPainter painter( &actual );
+        _helper->renderLineEdit( &painter, rect, background, outline, hasFocus, false, true, true, AnimationMode( mode ), opacity );
+    }
+
+    QImage expected( createImage( rect.size() ) );
+    {
+        QPainter painter( &expected );
+        referenceRenderLineEdit( *_helper, &painter, rect, background, outline, hasFocus, false, true, true, AnimationMode( mode ), opacity );
+    }
+
+    /*
+    the focus ring is revealed with a clip path, which is not antialiased,
+    so that the edge of the reveal disc is not compared during animations
+    */
+    Circle reveal;
+    if( mode == AnimationFocus )
+    {
+        QRectF frameRect( rect.adjusted( Metrics::Frame_FrameWidth, Metrics::Frame_FrameWidth, -Metrics::Frame_FrameWidth, -Metrics::Frame_FrameWidth ) );
+        if( hasFocus ) frameRect.adjust( 1, 1, -1, -1 );
+        reveal.center = QPointF( frameRect.x(), frameRect.y() + frameRect.height()/2 );
+        reveal.radius = ( frameRect.width() + Metrics::Frame_FrameWidth )*opacity;
+    }
+
+    QString message;
+    QVERIFY2( compareImages( actual, expected, message, reveal ), qPrintable( message ) );
+
+}
+
+QTEST_MAIN( RenderTest )
+
+#include "lightlyrendertest.moc"
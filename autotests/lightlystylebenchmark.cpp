@@ -0,0 +1,324 @@
+/*************************************************************************
+ * This program is free software; you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation; either version 2 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program; if not, write to the                         *
+ * Free Software Foundation, Inc.,                                       *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA .        *
+ *************************************************************************/
+
+/*
+ * paint benchmarks for the lightly style
+ *
+ * a fixed widget gallery is rendered into images by the built plugin,
+ * in normal, hover, focus, pressed and animated states, at device pixel ratio 1 and 2.
+ * Run with QT_QPA_PLATFORM=offscreen. The usual QTest options apply,
+ * e.g. -callgrind for instruction counts, or -tickcounter.
+ */
+
+#include <QApplication>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QHoverEvent>
+#include <QImage>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QMenu>
+#include <QPluginLoader>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QRadioButton>
+#include <QScopedPointer>
+#include <QScrollBar>
+#include <QStandardPaths>
+#include <QStylePlugin>
+#include <QTabBar>
+#include <QTest>
+#include <QToolButton>
+#include <QTreeWidget>
+
+class StyleBenchmark: public QObject
+{
+
+    Q_OBJECT
+
+    public:
+
+    //* widget state
+    enum State
+    {
+        Normal,
+        Hover,
+        Focus,
+        Pressed,
+        Animated
+    };
+
+    private Q_SLOTS:
+
+    //* load style plugin
+    void initTestCase();
+
+    //* cleanup
+    void cleanupTestCase();
+
+    //* render widget gallery
+    void render_data();
+    void render();
+
+    private:
+
+    //* create widget matching name
+    QWidget* createWidget( const QString& ) const;
+
+    //* top level window, so that widgets can get focus
+    QWidget* _window = nullptr;
+
+};
+
+//___________________________________________________________
+void StyleBenchmark::initTestCase()
+{
+
+    // do not pick up the user configuration
+    QStandardPaths::setTestModeEnabled( true );
+
+    QPluginLoader loader( QStringLiteral( LIGHTLY_PLUGIN_FILE ) );
+    auto plugin = qobject_cast<QStylePlugin*>( loader.instance() );
+    QVERIFY2( plugin, qPrintable( loader.errorString() ) );
+
+    QStyle* style( plugin->create( QStringLiteral( "lightly" ) ) );
+    QVERIFY( style );
+    QApplication::setStyle( style );
+
+    _window = new QWidget;
+    _window->resize( 400, 400 );
+    _window->show();
+    QVERIFY( QTest::qWaitForWindowExposed( _window ) );
+
+}
+
+//___________________________________________________________
+void StyleBenchmark::cleanupTestCase()
+{ delete _window; }
+
+//___________________________________________________________
+QWidget* StyleBenchmark::createWidget( const QString& name ) const
+{
+
+    if( name == QLatin1String( "pushbutton" ) ) return new QPushButton( QStringLiteral( "Push button" ) );
+    else if( name == QLatin1String( "toolbutton" ) )
+    {
+        auto button = new QToolButton;
+        button->setText( QStringLiteral( "Tool button" ) );
+        button->setToolButtonStyle( Qt::ToolButtonTextOnly );
+        return button;
+
+    } else if( name == QLatin1String( "checkbox" ) ) return new QCheckBox( QStringLiteral( "Check box" ) );
+    else if( name == QLatin1String( "radiobutton" ) ) return new QRadioButton( QStringLiteral( "Radio button" ) );
+    else if( name == QLatin1String( "lineedit" ) ) return new QLineEdit( QStringLiteral( "Line edit" ) );
+    else if( name == QLatin1String( "combobox" ) )
+    {
+
+        auto comboBox = new QComboBox;
+        comboBox->addItems( { QStringLiteral( "First" ), QStringLiteral( "Second" ), QStringLiteral( "Third" ) } );
+        return comboBox;
+
+    } else if( name == QLatin1String( "tabbar" ) ) {
+
+        auto tabBar = new QTabBar;
+        for( int i = 0; i < 4; ++i ) tabBar->addTab( QStringLiteral( "Tab %1" ).arg( i ) );
+        return tabBar;
+
+    } else if( name == QLatin1String( "scrollbar" ) ) {
+
+        auto scrollBar = new QScrollBar( Qt::Vertical );
+        scrollBar->setRange( 0, 100 );
+        scrollBar->setValue( 30 );
+        scrollBar->resize( scrollBar->sizeHint().width(), 200 );
+        return scrollBar;
+
+    } else if( name == QLatin1String( "listview" ) ) {
+
+        auto listWidget = new QListWidget;
+        for( int i = 0; i < 20; ++i ) listWidget->addItem( QStringLiteral( "Item %1" ).arg( i ) );
+        listWidget->setCurrentRow( 2 );
+        listWidget->resize( 200, 200 );
+        return listWidget;
+
+    } else if( name == QLatin1String( "treeview" ) ) {
+
+        auto treeWidget = new QTreeWidget;
+        treeWidget->setHeaderLabels( { QStringLiteral( "Name" ), QStringLiteral( "Value" ) } );
+        for( int i = 0; i < 5; ++i )
+        {
+            auto item = new QTreeWidgetItem( treeWidget, { QStringLiteral( "Item %1" ).arg( i ), QString::number( i ) } );
+            for( int j = 0; j < 3; ++j ) new QTreeWidgetItem( item, { QStringLiteral( "Child %1" ).arg( j ), QString::number( j ) } );
+        }
+
+        treeWidget->expandAll();
+        treeWidget->setCurrentItem( treeWidget->topLevelItem( 1 ) );
+        treeWidget->resize( 200, 200 );
+        return treeWidget;
+
+    } else if( name == QLatin1String( "menu" ) ) {
+
+        auto menu = new QMenu;
+        menu->addAction( QStringLiteral( "Action" ) );
+        auto action = menu->addAction( QStringLiteral( "Checkable action" ) );
+        action->setCheckable( true );
+        action->setChecked( true );
+        menu->addSeparator();
+        menu->addMenu( QStringLiteral( "Submenu" ) )->addAction( QStringLiteral( "Action" ) );
+        menu->setActiveAction( action );
+        return menu;
+
+    } else if( name == QLatin1String( "progressbar" ) ) {
+
+        auto progressBar = new QProgressBar;
+        progressBar->setRange( 0, 100 );
+        progressBar->setValue( 40 );
+        return progressBar;
+
+    } else if( name == QLatin1String( "busyprogressbar" ) ) {
+
+        auto progressBar = new QProgressBar;
+        progressBar->setRange( 0, 0 );
+        return progressBar;
+
+    }
+
+    return nullptr;
+
+}
+
+//___________________________________________________________
+void StyleBenchmark::render_data()
+{
+
+    QTest::addColumn<QString>( "name" );
+    QTest::addColumn<int>( "state" );
+    QTest::addColumn<qreal>( "devicePixelRatio" );
+
+    const QStringList buttons( {
+        QStringLiteral( "pushbutton" ),
+        QStringLiteral( "toolbutton" ),
+        QStringLiteral( "checkbox" ),
+        QStringLiteral( "radiobutton" ) } );
+
+    const QStringList others( {
+        QStringLiteral( "lineedit" ),
+        QStringLiteral( "combobox" ),
+        QStringLiteral( "tabbar" ),
+        QStringLiteral( "scrollbar" ),
+        QStringLiteral( "listview" ),
+        QStringLiteral( "treeview" ),
+        QStringLiteral( "menu" ),
+        QStringLiteral( "progressbar" ),
+        QStringLiteral( "busyprogressbar" ) } );
+
+    const QList<QPair<int, QString>> states( {
+        { Normal, QStringLiteral( "normal" ) },
+        { Hover, QStringLiteral( "hover" ) },
+        { Focus, QStringLiteral( "focus" ) },
+        { Pressed, QStringLiteral( "pressed" ) },
+        { Animated, QStringLiteral( "animated" ) } } );
+
+    for( const qreal devicePixelRatio : { 1.0, 2.0 } )
+    {
+        for( const auto& name : buttons + others )
+        {
+            for( const auto& state : states )
+            {
+                // only buttons can be pressed
+                if( state.first == Pressed && !buttons.contains( name ) ) continue;
+
+                // menus are top level widgets, that are not shown
+                if( state.first == Focus && name == QLatin1String( "menu" ) ) continue;
+
+                const QString tag( QStringLiteral( "%1/%2@%3x" ).arg( name, state.second ).arg( devicePixelRatio ) );
+                QTest::newRow( qPrintable( tag ) ) << name << state.first << devicePixelRatio;
+            }
+        }
+    }
+
+}
+
+//___________________________________________________________
+void StyleBenchmark::render()
+{
+
+    QFETCH( QString, name );
+    QFETCH( int, state );
+    QFETCH( qreal, devicePixelRatio );
+
+    QScopedPointer<QWidget> widget( createWidget( name ) );
+    QVERIFY( widget );
+
+    // menus are top level widgets
+    if( !qobject_cast<QMenu*>( widget.data() ) ) widget->setParent( _window );
+    if( !widget->testAttribute( Qt::WA_Resized ) ) widget->resize( widget->sizeHint().expandedTo( QSize( 160, 24 ) ) );
+    if( widget->parentWidget() ) widget->show();
+
+    QImage image( widget->size()*devicePixelRatio, QImage::Format_ARGB32_Premultiplied );
+    image.setDevicePixelRatio( devicePixelRatio );
+
+    switch( state )
+    {
+
+        case Hover:
+        widget->setAttribute( Qt::WA_UnderMouse );
+        break;
+
+        case Focus:
+        _window->activateWindow();
+        QVERIFY( QTest::qWaitForWindowActive( _window ) );
+        widget->setFocus( Qt::OtherFocusReason );
+        QVERIFY( widget->hasFocus() );
+        break;
+
+        case Pressed:
+        if( auto button = qobject_cast<QAbstractButton*>( widget.data() ) ) button->setDown( true );
+        break;
+
+        case Animated:
+        {
+            // paint once, so that the animation engines record the normal state to animate from
+            image.fill( Qt::transparent );
+            widget->render( &image );
+
+            // start the hover animation. Without event loop, it stays in progress while benchmarking
+            widget->setAttribute( Qt::WA_UnderMouse );
+            QEvent enter( QEvent::Enter );
+            QApplication::sendEvent( widget.data(), &enter );
+            QHoverEvent hoverEnter( QEvent::HoverEnter, QPointF( widget->rect().center() ), QPointF( -1, -1 ) );
+            QApplication::sendEvent( widget.data(), &hoverEnter );
+
+            // the state change is picked up when painting, which starts the animation
+            widget->render( &image );
+            break;
+        }
+
+        default: break;
+
+    }
+
+    QBENCHMARK
+    {
+        image.fill( Qt::transparent );
+        widget->render( &image );
+    }
+
+}
+
+QTEST_MAIN( StyleBenchmark )
+
+#include "lightlystylebenchmark.moc"
@@ -24,6 +24,7 @@
 #include <KColorUtils>
 #include <KIconLoader>
 
+#include <QCache>
 #include <QPainter>
 #include <QVariantAnimation>
 #include <QPainterPath>
@@ -35,6 +36,68 @@ namespace Lightly
     using KDecoration2::ColorGroup;
     using KDecoration2::DecorationButtonType;
 
+    namespace
+    {
+
+        //* key used to cache button icons
+        struct IconCacheKey
+        {
+
+            IconCacheKey( DecorationButtonType type, bool checked, int size, const QColor& foreground, const QColor& background, const QColor& mark, qreal devicePixelRatio ):
+                type( int( type ) ),
+                checked( checked ),
+                size( size ),
+                foreground( rgba( foreground ) ),
+                background( rgba( background ) ),
+                mark( rgba( mark ) ),
+                devicePixelRatio( qRound( devicePixelRatio*100 ) )
+            {}
+
+            bool operator == ( const IconCacheKey& other ) const
+            {
+                return
+                    type == other.type &&
+                    checked == other.checked &&
+                    size == other.size &&
+                    foreground == other.foreground &&
+                    background == other.background &&
+                    mark == other.mark &&
+                    devicePixelRatio == other.devicePixelRatio;
+            }
+
+            //* invalid colors are not painted, same as fully transparent ones
+            static QRgb rgba( const QColor& color )
+            { return color.isValid() ? color.rgba() : 0; }
+
+            int type;
+            bool checked;
+            int size;
+            QRgb foreground;
+            QRgb background;
+            QRgb mark;
+            int devicePixelRatio;
+
+        };
+
+        //* hash
+        inline uint qHash( const IconCacheKey& key, uint seed = 0 )
+        {
+            return ::qHash( key.type | ( key.checked << 8 ) | ( key.size << 9 ), seed ) ^
+                ::qHash( key.foreground, seed ) ^
+                ::qHash( key.background << 1, seed ) ^
+                ::qHash( key.mark << 2, seed ) ^
+                ::qHash( key.devicePixelRatio << 20, seed );
+        }
+
+    }
+
+    //* rendered button icons, shared by all decorations
+    static QCache<IconCacheKey, QPixmap> g_sIconCache( 512 );
+
+    //__________________________________________________________________
+    void Button::clearIconCache()
+    { g_sIconCache.clear(); }
+
 
     //__________________________________________________________________
     Button::Button(DecorationButtonType type, Decoration* decoration, QObject* parent)
@@ -111,6 +174,7 @@ namespace Lightly
 
                 case DecorationButtonType::Menu:
                 QObject::connect(d->client().data(), &KDecoration2::DecoratedClient::iconChanged, b, [b]() { b->update(); });
+                QObject::connect(d->client().data(), &KDecoration2::DecoratedClient::paletteChanged, b, [b]() { b->m_menuIcon = QPixmap(); b->update(); });
                 break;
 
                 default: break;
@@ -143,21 +207,7 @@ namespace Lightly
         if (type() == DecorationButtonType::Menu)
         {
 
-            const QRectF iconRect( geometry().topLeft(), m_iconSize );
-            if (auto deco =  qobject_cast<Decoration*>(decoration())) {
-                const QPalette activePalette = KIconLoader::global()->customPalette();
-                QPalette palette = decoration()->client().data()->palette();
-                palette.setColor(QPalette::Foreground, deco->fontColor());
-                KIconLoader::global()->setCustomPalette(palette);
-                decoration()->client().data()->icon().paint(painter, iconRect.toRect());
-                if (activePalette == QPalette()) {
-                    KIconLoader::global()->resetPalette();
-                }    else {
-                    KIconLoader::global()->setCustomPalette(palette);
-                }
-            } else {
-                decoration()->client().data()->icon().paint(painter, iconRect.toRect());
-            }
+            drawMenuIcon( painter );
 
         } else {
 
@@ -169,8 +219,118 @@ namespace Lightly
 
     }
 
+    //__________________________________________________________________
+    void Button::drawMenuIcon( QPainter *painter )
+    {
+
+        const QRect iconRect( QRectF( geometry().topLeft(), m_iconSize ).toRect() );
+        auto deco = qobject_cast<Decoration*>( decoration() );
+        const QIcon icon( decoration()->client().data()->icon() );
+
+        // paint client icon, using font color for monochrome icons
+        auto paintIcon = [deco, &icon]( QPainter* painter, const QRect& rect )
+        {
+            if( !deco )
+            {
+                icon.paint( painter, rect );
+                return;
+            }
+
+            const QPalette activePalette = KIconLoader::global()->customPalette();
+            QPalette palette = deco->client().data()->palette();
+            palette.setColor(QPalette::Foreground, deco->fontColor());
+            KIconLoader::global()->setCustomPalette(palette);
+            icon.paint( painter, rect );
+            if (activePalette == QPalette()) {
+                KIconLoader::global()->resetPalette();
+            }    else {
+                KIconLoader::global()->setCustomPalette(activePalette);
+            }
+        };
+
+        // icon is cached unless painter is scaled or rotated
+        if( painter->transform().type() > QTransform::TxTranslate )
+        {
+            paintIcon( painter, iconRect );
+            return;
+        }
+
+        const qreal dpr( painter->device()->devicePixelRatioF() );
+        const QRgb color( deco ? deco->fontColor().rgba() : 0 );
+        if( m_menuIcon.isNull() ||
+            m_menuIconKey != icon.cacheKey() ||
+            m_menuIconColor != color ||
+            m_menuIcon.size() != iconRect.size()*dpr ||
+            m_menuIcon.devicePixelRatioF() != dpr )
+        {
+            m_menuIcon = QPixmap( iconRect.size()*dpr );
+            m_menuIcon.setDevicePixelRatio( dpr );
+            m_menuIcon.fill( Qt::transparent );
+
+            QPainter p( &m_menuIcon );
+            paintIcon( &p, QRect( QPoint(), iconRect.size() ) );
+            p.end();
+
+            m_menuIconKey = icon.cacheKey();
+            m_menuIconColor = color;
+        }
+
+        painter->drawPixmap( iconRect.topLeft(), m_menuIcon );
+
+    }
+
     //__________________________________________________________________
     void Button::drawIcon( QPainter *painter ) const
+    {
+
+        const QColor foregroundColor( this->foregroundColor() );
+        const QColor backgroundColor( this->backgroundColor() );
+
+        // center dot of the checked on all desktops icon
+        QColor markColor;
+        if( type() == DecorationButtonType::OnAllDesktops && isChecked() )
+        {
+            markColor = backgroundColor;
+            auto d = qobject_cast<Decoration*>( decoration() );
+            if( !markColor.isValid() && d ) markColor = d->titleBarColor();
+        }
+
+        // icon is cached unless painter is scaled or rotated
+        if( painter->transform().type() > QTransform::TxTranslate )
+        {
+            painter->translate( geometry().topLeft() );
+            renderIcon( painter, type(), isChecked(), m_iconSize.width(), foregroundColor, backgroundColor, markColor );
+            return;
+        }
+
+        const qreal dpr( painter->device()->devicePixelRatioF() );
+        const IconCacheKey key( type(), isChecked(), m_iconSize.width(), foregroundColor, backgroundColor, markColor, dpr );
+        QPixmap pixmap;
+        if( const QPixmap* cached = g_sIconCache.object( key ) )
+        {
+
+            pixmap = *cached;
+
+        } else {
+
+            pixmap = QPixmap( m_iconSize*dpr );
+            pixmap.setDevicePixelRatio( dpr );
+            pixmap.fill( Qt::transparent );
+
+            QPainter p( &pixmap );
+            renderIcon( &p, type(), isChecked(), m_iconSize.width(), foregroundColor, backgroundColor, markColor );
+            p.end();
+
+            g_sIconCache.insert( key, new QPixmap( pixmap ) );
+
+        }
+
+        painter->drawPixmap( geometry().topLeft(), pixmap );
+
+    }
+
+    //__________________________________________________________________
+    void Button::renderIcon( QPainter *painter, DecorationButtonType type, bool checked, qreal width, const QColor& foregroundColor, const QColor& backgroundColor, const QColor& markColor )
     {
 
         painter->setRenderHints( QPainter::Antialiasing );
@@ -180,14 +340,10 @@ namespace Lightly
         this makes all further rendering and scaling simpler
         all further rendering is preformed inside QRect( 0, 0, 18, 18 )
         */
-        painter->translate( geometry().topLeft() );
-
-        const qreal width( m_iconSize.width() );
         painter->scale( width/20, width/20 );
         painter->translate( 1, 1 );
 
         // render background
-        const QColor backgroundColor( this->backgroundColor() );
         if( backgroundColor.isValid() )
         {
             painter->setPen( Qt::NoPen );
@@ -196,7 +352,6 @@ namespace Lightly
         }
 
         // render mark
-        const QColor foregroundColor( this->foregroundColor() );
         if( foregroundColor.isValid() )
         {
 
@@ -209,7 +364,7 @@ namespace Lightly
             painter->setPen( pen );
             painter->setBrush( Qt::NoBrush );
 
-            switch( type() )
+            switch( type )
             {
 
                 case DecorationButtonType::Close:
@@ -221,7 +376,7 @@ namespace Lightly
 
                 case DecorationButtonType::Maximize:
                 {
-                    if( isChecked() )
+                    if( checked )
                     {
                         pen.setJoinStyle( Qt::RoundJoin );
                         painter->setPen( pen );
@@ -255,20 +410,16 @@ namespace Lightly
                     painter->setPen( Qt::NoPen );
                     painter->setBrush( foregroundColor );
 
-                    if( isChecked())
+                    if( checked)
                     {
 
                         // outer ring
                         painter->drawEllipse( QRectF( 3, 3, 12, 12 ) );
 
                         // center dot
-                        QColor backgroundColor( this->backgroundColor() );
-                        auto d = qobject_cast<Decoration*>( decoration() );
-                        if( !backgroundColor.isValid() && d ) backgroundColor = d->titleBarColor();
-
-                        if( backgroundColor.isValid() )
+                        if( markColor.isValid() )
                         {
-                            painter->setBrush( backgroundColor );
+                            painter->setBrush( markColor );
                             painter->drawEllipse( QRectF( 8, 8, 2, 2 ) );
                         }
 
@@ -290,7 +441,7 @@ namespace Lightly
                 case DecorationButtonType::Shade:
                 {
 
-                    if (isChecked())
+                    if (checked)
                     {
 
                         painter->drawLine( QPointF( 4, 5.5 ), QPointF( 14, 5.5 ) );
@@ -380,29 +531,32 @@ namespace Lightly
 
             return QColor();
 
-        } else if( isPressed() ) {
+        }
+
+        const auto& colors( d->colors() );
+        if( isPressed() ) {
 
-            return d->titleBarColor();
+            return colors.titleBar;
 
-        } else if( type() == DecorationButtonType::Close && d->internalSettings()->outlineCloseButton() ) {
+        } else if( type() == DecorationButtonType::Close && colors.outlineCloseButton ) {
 
-            return d->titleBarColor();
+            return colors.titleBar;
 
         } else if( ( type() == DecorationButtonType::KeepBelow || type() == DecorationButtonType::KeepAbove || type() == DecorationButtonType::Shade ) && isChecked() ) {
 
-            return d->titleBarColor();
+            return colors.titleBar;
 
         } else if( m_animation->state() == QAbstractAnimation::Running ) {
 
-            return KColorUtils::mix( d->fontColor(), d->titleBarColor(), m_opacity );
+            return KColorUtils::mix( colors.font, colors.titleBar, m_opacity );
 
         } else if( isHovered() ) {
 
-            return d->titleBarColor();
+            return colors.titleBar;
 
         } else {
 
-            return d->fontColor();
+            return colors.font;
 
         }
 
@@ -418,28 +572,28 @@ namespace Lightly
 
         }
 
-        auto c = d->client().data();
+        const auto& colors( d->colors() );
         if( isPressed() ) {
 
-            if( type() == DecorationButtonType::Close ) return c->color( ColorGroup::Warning, ColorRole::Foreground );
-            else return KColorUtils::mix( d->titleBarColor(), d->fontColor(), 0.3 );
+            if( type() == DecorationButtonType::Close ) return colors.closePressed;
+            else return colors.pressed;
 
         } else if( ( type() == DecorationButtonType::KeepBelow || type() == DecorationButtonType::KeepAbove || type() == DecorationButtonType::Shade ) && isChecked() ) {
 
-            return d->fontColor();
+            return colors.font;
 
         } else if( m_animation->state() == QAbstractAnimation::Running ) {
 
             if( type() == DecorationButtonType::Close )
             {
-                if( d->internalSettings()->outlineCloseButton() )
+                if( colors.outlineCloseButton )
                 {
 
-                    return KColorUtils::mix( d->fontColor(), c->color( ColorGroup::Warning, ColorRole::Foreground ).lighter(), m_opacity );
+                    return KColorUtils::mix( colors.font, colors.closeHovered, m_opacity );
 
                 } else {
 
-                    QColor color( c->color( ColorGroup::Warning, ColorRole::Foreground ).lighter() );
+                    QColor color( colors.closeHovered );
                     color.setAlpha( color.alpha()*m_opacity );
                     return color;
 
@@ -447,7 +601,7 @@ namespace Lightly
 
             } else {
 
-                QColor color( d->fontColor() );
+                QColor color( colors.font );
                 color.setAlpha( color.alpha()*m_opacity );
                 return color;
 
@@ -455,12 +609,12 @@ namespace Lightly
 
         } else if( isHovered() ) {
 
-            if( type() == DecorationButtonType::Close ) return c->color( ColorGroup::Warning, ColorRole::Foreground ).lighter();
-            else return d->fontColor();
+            if( type() == DecorationButtonType::Close ) return colors.closeHovered;
+            else return colors.font;
 
-        } else if( type() == DecorationButtonType::Close && d->internalSettings()->outlineCloseButton() ) {
+        } else if( type() == DecorationButtonType::Close && colors.outlineCloseButton ) {
 
-            return d->fontColor();
+            return colors.font;
 
         } else {
 
@@ -26,6 +26,7 @@
 
 #include <QHash>
 #include <QImage>
+#include <QPixmap>
 
 class QVariantAnimation;
 
@@ -50,6 +51,9 @@ namespace Lightly
         //* render
         virtual void paint(QPainter *painter, const QRect &repaintRegion) override;
 
+        //* clear icon cache shared by all buttons
+        static void clearIconCache();
+
         //* flag
         enum Flag
         {
@@ -86,6 +90,8 @@ namespace Lightly
         //@{
         void setOpacity( qreal value )
         {
+            // use discrete steps, so that animated icons can be cached
+            value = qRound( value*32 )/32.0;
             if( m_opacity == value ) return;
             m_opacity = value;
             update();
@@ -112,6 +118,12 @@ namespace Lightly
         //* draw button icon
         void drawIcon( QPainter *) const;
 
+        //* render button icon inside QRect( 0, 0, width, width )
+        static void renderIcon( QPainter*, KDecoration2::DecorationButtonType, bool checked, qreal width, const QColor& foreground, const QColor& background, const QColor& mark );
+
+        //* draw menu button icon
+        void drawMenuIcon( QPainter* );
+
         //*@name colors
         //@{
         QColor foregroundColor() const;
@@ -131,6 +143,13 @@ namespace Lightly
 
         //* active state change opacity
         qreal m_opacity = 0;
+
+        //*@name cached menu icon, invalidated when client icon, font color or size change
+        //@{
+        QPixmap m_menuIcon;
+        qint64 m_menuIconKey = 0;
+        QRgb m_menuIconColor = 0;
+        //@}
     };
 
 } // namespace
@@ -43,6 +43,7 @@
 #include <KPluginFactory>
 
 #include <QPainter>
+#include <QPainterPath>
 #include <QTextStream>
 #include <QTimer>
 #include <QVariantAnimation>
@@ -170,8 +171,9 @@ namespace Lightly
     {
         g_sDecoCount--;
         if (g_sDecoCount == 0) {
-            // last deco destroyed, clean up shadow
+            // last deco destroyed, clean up shadow and button icons
             g_sShadow.clear();
+            Button::clearIconCache();
         }
 
         deleteSizeGrip();
@@ -183,54 +185,58 @@ namespace Lightly
     {
         if( m_opacity == value ) return;
         m_opacity = value;
+        updateColors();
         update();
 
         if( m_sizeGrip ) m_sizeGrip->update();
     }
 
     //________________________________________________________________
-    QColor Decoration::titleBarColor() const
+    void Decoration::updateColors()
     {
 
         auto c = client().data();
-        if( hideTitleBar() ) return c->color( ColorGroup::Inactive, ColorRole::TitleBar );
-        else if( m_animation->state() == QAbstractAnimation::Running )
+        const bool animated( m_animation->state() == QAbstractAnimation::Running );
+
+        Colors colors;
+
+        // title bar
+        if( hideTitleBar() ) colors.titleBar = c->color( ColorGroup::Inactive, ColorRole::TitleBar );
+        else if( animated )
         {
-            return KColorUtils::mix(
+            colors.titleBar = KColorUtils::mix(
                 c->color( ColorGroup::Inactive, ColorRole::TitleBar ),
                 c->color( ColorGroup::Active, ColorRole::TitleBar ),
                 m_opacity );
-        } else return c->color( c->isActive() ? ColorGroup::Active : ColorGroup::Inactive, ColorRole::TitleBar );
-
-    }
-
-    //________________________________________________________________
-    QColor Decoration::outlineColor() const
-    {
+        } else colors.titleBar = c->color( c->isActive() ? ColorGroup::Active : ColorGroup::Inactive, ColorRole::TitleBar );
 
-        auto c( client().data() );
-        if( !m_internalSettings->drawTitleBarSeparator() ) return QColor();
-        if( m_animation->state() == QAbstractAnimation::Running )
+        // outline
+        if( !m_internalSettings->drawTitleBarSeparator() ) colors.outline = QColor();
+        else if( animated )
         {
-            QColor color( c->palette().color( QPalette::Highlight ) );
-            color.setAlpha( color.alpha()*m_opacity );
-            return color;
-        } else if( c->isActive() ) return c->palette().color( QPalette::Highlight );
-        else return QColor();
-    }
-
-    //________________________________________________________________
-    QColor Decoration::fontColor() const
-    {
+            colors.outline = c->palette().color( QPalette::Highlight );
+            colors.outline.setAlpha( colors.outline.alpha()*m_opacity );
+        } else if( c->isActive() ) colors.outline = c->palette().color( QPalette::Highlight );
 
-        auto c = client().data();
-        if( m_animation->state() == QAbstractAnimation::Running )
+        // font
+        if( animated )
         {
-            return KColorUtils::mix(
+            colors.font = KColorUtils::mix(
                 c->color( ColorGroup::Inactive, ColorRole::Foreground ),
                 c->color( ColorGroup::Active, ColorRole::Foreground ),
                 m_opacity );
-        } else return  c->color( c->isActive() ? ColorGroup::Active : ColorGroup::Inactive, ColorRole::Foreground );
+        } else colors.font = c->color( c->isActive() ? ColorGroup::Active : ColorGroup::Inactive, ColorRole::Foreground );
+
+        // buttons
+        colors.closePressed = c->color( ColorGroup::Warning, ColorRole::Foreground );
+        colors.closeHovered = colors.closePressed.lighter();
+        colors.pressed = KColorUtils::mix( colors.titleBar, colors.font, 0.3 );
+
+        // flags
+        colors.outlineCloseButton = m_internalSettings->outlineCloseButton();
+        colors.drawHighlight = qGray( colors.titleBar.rgb() ) < 130 && m_internalSettings->drawHighlight();
+
+        m_colors = colors;
 
     }
 
@@ -248,6 +254,12 @@ namespace Lightly
             setOpacity(value.toReal());
         });
 
+        // colors depend on whether the animation is running
+        connect(m_animation, &QAbstractAnimation::stateChanged, this, [this]() {
+            updateColors();
+            update();
+        });
+
         reconfigure();
         updateTitleBar();
         auto s = settings();
@@ -279,6 +291,15 @@ namespace Lightly
             }
         );
 
+        connect(c, &KDecoration2::DecoratedClient::shadedChanged, this, &Decoration::updateColors);
+        connect(c, &KDecoration2::DecoratedClient::paletteChanged, this,
+            [this]()
+            {
+                updateColors();
+                update();
+            }
+        );
+
         connect(c, &KDecoration2::DecoratedClient::activeChanged, this, &Decoration::updateAnimationState);
         connect(c, &KDecoration2::DecoratedClient::widthChanged, this, &Decoration::updateTitleBar);
         connect(c, &KDecoration2::DecoratedClient::maximizedChanged, this, &Decoration::updateTitleBar);
@@ -317,6 +338,7 @@ namespace Lightly
 
         } else {
 
+            updateColors();
             update();
 
         }
@@ -374,6 +396,12 @@ namespace Lightly
 
         m_internalSettings = SettingsProvider::self()->internalSettings( this );
 
+        // title bar background depends on settings
+        m_titleBarCache = TitleBarCache();
+
+        // colors depend on settings
+        updateColors();
+
         // animation
         m_animation->setDuration( m_internalSettings->animationsDuration() );
 
@@ -519,29 +547,37 @@ namespace Lightly
     //________________________________________________________________
     void Decoration::paint(QPainter *painter, const QRect &repaintRegion)
     {
-        // TODO: optimize based on repaintRegion
         auto c = client().data();
         auto s = settings();
 
+        // only touch the dirty part of the decoration
+        const QRect dirtyRect( repaintRegion.isValid() ? repaintRegion.intersected( rect() ) : rect() );
+        if( dirtyRect.isEmpty() ) return;
+
         // paint background
         if( !c->isShaded() )
         {
-            painter->fillRect(rect(), Qt::transparent);
-            painter->save();
-            painter->setRenderHint(QPainter::Antialiasing);
-            painter->setPen(Qt::NoPen);
-            painter->setBrush( c->color( c->isActive() ? ColorGroup::Active : ColorGroup::Inactive, ColorRole::Frame ) );
+            painter->fillRect(dirtyRect, Qt::transparent);
+
+            const QRect frameRect( hideTitleBar() ? rect() : QRect( 0, borderTop(), size().width(), size().height() - borderTop() ) );
+            if( frameRect.intersects( dirtyRect ) )
+            {
+                painter->save();
+                painter->setRenderHint(QPainter::Antialiasing);
+                painter->setPen(Qt::NoPen);
+                painter->setBrush( c->color( c->isActive() ? ColorGroup::Active : ColorGroup::Inactive, ColorRole::Frame ) );
 
-            // clip away the top part
-            if( !hideTitleBar() ) painter->setClipRect(0, borderTop(), size().width(), size().height() - borderTop(), Qt::IntersectClip);
+                // clip away the top part, and whatever does not need repainting
+                painter->setClipRect(frameRect.intersected( dirtyRect ), Qt::IntersectClip);
 
-            if( s->isAlphaChannelSupported() ) painter->drawRoundedRect(rect(), m_internalSettings->cornerRadius(), m_internalSettings->cornerRadius());
-            else painter->drawRect( rect() );
+                if( s->isAlphaChannelSupported() ) painter->drawRoundedRect(rect(), m_internalSettings->cornerRadius(), m_internalSettings->cornerRadius());
+                else painter->drawRect( rect() );
 
-            painter->restore();
+                painter->restore();
+            }
         }
 
-        if( !hideTitleBar() ) paintTitleBar(painter, repaintRegion);
+        if( !hideTitleBar() ) paintTitleBar(painter, dirtyRect);
 
         if( hasBorders() && !s->isAlphaChannelSupported() )
         {
@@ -566,14 +602,98 @@ namespace Lightly
 
         if ( !titleRect.intersects(repaintRegion) ) return;
 
-        painter->save();
+        auto s = settings();
+
+        // state the cached background depends on
+        enum
+        {
+            Gradient = 1<<0,
+            Square = 1<<1,
+            Shaded = 1<<2,
+            LeftEdge = 1<<3,
+            TopEdge = 1<<4,
+            RightEdge = 1<<5,
+            Highlight = 1<<6
+        };
+
+        const QColor titleBarColor( m_colors.titleBar );
+        int flags = 0;
+        if( c->isActive() && m_internalSettings->drawBackgroundGradient() ) flags |= Gradient;
+        if( isMaximized() || !s->isAlphaChannelSupported() ) flags |= Square;
+        if( c->isShaded() ) flags |= Shaded;
+        if( isLeftEdge() ) flags |= LeftEdge;
+        if( isTopEdge() ) flags |= TopEdge;
+        if( isRightEdge() ) flags |= RightEdge;
+        if( m_colors.drawHighlight ) flags |= Highlight;
+
+        const qreal dpr( painter->device() ? painter->device()->devicePixelRatioF() : 1.0 );
+
+        // regenerate background if needed
+        if( m_titleBarCache.pixmap.isNull()
+            || m_titleBarCache.size != titleRect.size()
+            || m_titleBarCache.color != titleBarColor.rgba()
+            || m_titleBarCache.devicePixelRatio != dpr
+            || m_titleBarCache.flags != flags )
+        {
+            QPixmap pixmap( titleRect.size()*dpr );
+            pixmap.setDevicePixelRatio( dpr );
+            pixmap.fill( Qt::transparent );
+
+            QPainter p( &pixmap );
+            p.setRenderHints( painter->renderHints() );
+            renderTitleBarBackground( &p, titleRect );
+            p.end();
+
+            m_titleBarCache.pixmap = pixmap;
+            m_titleBarCache.size = titleRect.size();
+            m_titleBarCache.color = titleBarColor.rgba();
+            m_titleBarCache.devicePixelRatio = dpr;
+            m_titleBarCache.flags = flags;
+        }
+
+        // only blit the dirty part of the title bar
+        const QRect dirtyRect( titleRect.intersected( repaintRegion ) );
+        painter->drawPixmap( QRectF( dirtyRect ), m_titleBarCache.pixmap, QRectF( dirtyRect.topLeft()*dpr, dirtyRect.size()*dpr ) );
+
+        const QColor outlineColor( m_colors.outline );
+        if( !c->isShaded() && outlineColor.isValid() )
+        {
+            // outline
+            painter->save();
+            painter->setRenderHint( QPainter::Antialiasing, false );
+            painter->setBrush( Qt::NoBrush );
+            painter->setPen( outlineColor );
+            painter->drawLine( titleRect.bottomLeft(), titleRect.bottomRight() );
+            painter->restore();
+        }
+
+        // draw caption
+        const auto cR = captionRect();
+        if( cR.first.intersects( repaintRegion ) )
+        {
+            painter->setFont(s->font());
+            painter->setPen( m_colors.font );
+            const QString caption = painter->fontMetrics().elidedText(c->caption(), Qt::ElideMiddle, cR.first.width());
+            painter->drawText(cR.first, cR.second | Qt::TextSingleLine, caption);
+        }
+
+        // draw all buttons
+        m_leftButtons->paint(painter, repaintRegion);
+        m_rightButtons->paint(painter, repaintRegion);
+    }
+
+    //________________________________________________________________
+    void Decoration::renderTitleBarBackground(QPainter *painter, const QRect &titleRect) const
+    {
+        const auto c = client().data();
+
         painter->setPen(Qt::NoPen);
 
         // render a linear gradient on title area
+        const QColor titleBarColor( m_colors.titleBar );
         if( c->isActive() && m_internalSettings->drawBackgroundGradient() )
         {
 
-            const QColor titleBarColor( this->titleBarColor() );
             QLinearGradient gradient( 0, 0, 0, titleRect.height() );
             gradient.setColorAt(0.0, titleBarColor.lighter( 120 ) );
             gradient.setColorAt(0.8, titleBarColor);
@@ -581,18 +701,20 @@ namespace Lightly
 
         } else {
 
-            painter->setBrush( titleBarColor() );
+            painter->setBrush( titleBarColor );
 
         }
 
+        const bool drawHighlight( m_colors.drawHighlight );
+
         auto s = settings();
         if( isMaximized() || !s->isAlphaChannelSupported() )
         {
 
             painter->drawRect(titleRect);
-            
+
             // top highlight
-            if( qGray(this->titleBarColor().rgb()) < 130 && m_internalSettings->drawHighlight() ) {
+            if( drawHighlight ) {
                 painter->setPen(QColor(255, 255, 255, 30));
                 painter->drawLine(titleRect.topLeft(), titleRect.topRight());
             }
@@ -604,59 +726,32 @@ namespace Lightly
         } else {
 
             painter->setClipRect(titleRect, Qt::IntersectClip);
-            
+
             // the rect is made a little bit larger to be able to clip away the rounded corners at the bottom and sides
             QRect copy ( titleRect.adjusted(
                 isLeftEdge() ? -m_internalSettings->cornerRadius():0,
                 isTopEdge() ? -m_internalSettings->cornerRadius():0,
                 isRightEdge() ? m_internalSettings->cornerRadius():0,
                 m_internalSettings->cornerRadius()) );
-            
-            
+
+
             painter->drawRoundedRect(copy, m_internalSettings->cornerRadius(), m_internalSettings->cornerRadius());
-            
-            // top highlight
-            if( qGray(this->titleBarColor().rgb()) < 130 && m_internalSettings->drawHighlight() ) {
-                QPixmap pix = QPixmap( copy.width(), copy.height() );
-                pix.fill( Qt::transparent );
-        
-                QPainter p(&pix);
-                p.setRenderHint( QPainter::Antialiasing );
-                p.setPen(Qt::NoPen);
-                p.setBrush(QColor(255, 255, 255, 30));
-                p.drawRoundedRect(copy, m_internalSettings->cornerRadius(), m_internalSettings->cornerRadius());
-                
-                p.setBrush(Qt::black);
-                p.setCompositionMode(QPainter::CompositionMode_DestinationOut);
-                p.drawRoundedRect(copy.adjusted(0, 1, 0, 0), m_internalSettings->cornerRadius(), m_internalSettings->cornerRadius());
-                
-                painter->drawPixmap(copy, pix);
-            }
 
-        }
+            // top highlight, the difference between the title bar shape and the same shape moved one pixel down
+            if( drawHighlight ) {
+                QPainterPath outer;
+                outer.addRoundedRect(copy, m_internalSettings->cornerRadius(), m_internalSettings->cornerRadius());
 
-        const QColor outlineColor( this->outlineColor() );
-        if( !c->isShaded() && outlineColor.isValid() )
-        {
-            // outline
-            painter->setRenderHint( QPainter::Antialiasing, false );
-            painter->setBrush( Qt::NoBrush );
-            painter->setPen( outlineColor );
-            painter->drawLine( titleRect.bottomLeft(), titleRect.bottomRight() );
-        }
+                QPainterPath inner;
+                inner.addRoundedRect(copy.adjusted(0, 1, 0, 0), m_internalSettings->cornerRadius(), m_internalSettings->cornerRadius());
 
-        painter->restore();
+                painter->setRenderHint( QPainter::Antialiasing );
+                painter->setBrush(QColor(255, 255, 255, 30));
+                painter->drawPath(outer.subtracted(inner));
+            }
 
-        // draw caption
-        painter->setFont(s->font());
-        painter->setPen( fontColor() );
-        const auto cR = captionRect();
-        const QString caption = painter->fontMetrics().elidedText(c->caption(), Qt::ElideMiddle, cR.first.width());
-        painter->drawText(cR.first, cR.second | Qt::TextSingleLine, caption);
+        }
 
-        // draw all buttons
-        m_leftButtons->paint(painter, repaintRegion);
-        m_rightButtons->paint(painter, repaintRegion);
     }
 
     //________________________________________________________________
@@ -772,12 +867,13 @@ namespace Lightly
             shadowRenderer.addShadow(params.shadow2.offset, params.shadow2.radius,
                 withOpacity(g_shadowColor, params.shadow2.opacity * strength));
 
-            QImage shadowTexture = shadowRenderer.render();
+            // both shadows share the same tint, render them as an alpha mask
+            QImage shadowMask = shadowRenderer.renderMask();
 
-            QPainter painter(&shadowTexture);
+            QPainter painter(&shadowMask);
             painter.setRenderHint(QPainter::Antialiasing);
 
-            const QRect outerRect = shadowTexture.rect();
+            const QRect outerRect = shadowMask.rect();
 
             QRect boxRect(QPoint(0, 0), boxSize);
             boxRect.moveCenter(outerRect.center());
@@ -813,7 +909,7 @@ namespace Lightly
             g_sShadow = QSharedPointer<KDecoration2::DecorationShadow>::create();
             g_sShadow->setPadding(padding);
             g_sShadow->setInnerShadowRect(QRect(outerRect.center(), QSize(1, 1)));
-            g_sShadow->setShadow(shadowTexture);
+            g_sShadow->setShadow(BoxShadowRenderer::colorize(shadowMask, QColor(g_shadowColor.rgb())));
         }
 
         setShadow(g_sShadow);
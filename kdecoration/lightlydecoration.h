@@ -30,6 +30,7 @@
 #include <KDecoration2/DecorationSettings>
 
 #include <QPalette>
+#include <QPixmap>
 #include <QVariant>
 
 class QVariantAnimation;
@@ -77,11 +78,38 @@ namespace Lightly
 
         //@}
 
+        //* colors and flags used for painting the decoration and its buttons
+        struct Colors
+        {
+            QColor titleBar;
+            QColor outline;
+            QColor font;
+
+            //* close button background, when hovered and pressed
+            QColor closeHovered;
+            QColor closePressed;
+
+            //* other buttons background, when pressed
+            QColor pressed;
+
+            bool outlineCloseButton = false;
+            bool drawHighlight = false;
+        };
+
+        //* colors, recomputed only when palette, active state, opacity or settings change
+        const Colors& colors() const
+        { return m_colors; }
+
         //*@name colors
         //@{
-        QColor titleBarColor() const;
-        QColor outlineColor() const;
-        QColor fontColor() const;
+        QColor titleBarColor() const
+        { return m_colors.titleBar; }
+
+        QColor outlineColor() const
+        { return m_colors.outline; }
+
+        QColor fontColor() const
+        { return m_colors.font; }
         //@}
 
         //*@name maximization modes
@@ -109,6 +137,7 @@ namespace Lightly
         void updateTitleBar();
         void updateAnimationState();
         void updateSizeGripVisibility();
+        void updateColors();
 
         private:
 
@@ -117,6 +146,7 @@ namespace Lightly
 
         void createButtons();
         void paintTitleBar(QPainter *painter, const QRect &repaintRegion);
+        void renderTitleBarBackground(QPainter *painter, const QRect &titleRect) const;
         void createShadow();
 
         //*@name border size
@@ -148,6 +178,21 @@ namespace Lightly
         //* active state change opacity
         qreal m_opacity = 0;
 
+        //* cached title bar background, regenerated when any of the parameters it depends on changes
+        struct TitleBarCache
+        {
+            QPixmap pixmap;
+            QSize size;
+            QRgb color = 0;
+            qreal devicePixelRatio = 0;
+            int flags = 0;
+        };
+
+        TitleBarCache m_titleBarCache;
+
+        //* colors
+        Colors m_colors;
+
     };
 
     bool Decoration::hasBorders() const
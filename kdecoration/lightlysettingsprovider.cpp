@@ -65,65 +65,94 @@ namespace Lightly
         exceptions.readConfig( m_config );
         m_exceptions = exceptions.get();
 
+        // compile exception patterns once
+        m_compiledExceptions.clear();
+        m_hasTitleExceptions = false;
+        m_hasClassExceptions = false;
+        foreach( auto internalSettings, m_exceptions )
+        {
+
+            // discard disabled exceptions
+            if( !internalSettings->enabled() ) continue;
+
+            // discard exceptions with empty exception pattern
+            if( internalSettings->exceptionPattern().isEmpty() ) continue;
+
+            Exception exception;
+            exception.settings = internalSettings;
+            exception.type = internalSettings->exceptionType() == InternalSettings::ExceptionWindowTitle ?
+                InternalSettings::ExceptionWindowTitle : InternalSettings::ExceptionWindowClassName;
+            exception.expression.setPattern( internalSettings->exceptionPattern() );
+
+            // discard invalid patterns, that would never match
+            if( !exception.expression.isValid() ) continue;
+            exception.expression.optimize();
+
+            if( exception.type == InternalSettings::ExceptionWindowTitle ) m_hasTitleExceptions = true;
+            else m_hasClassExceptions = true;
+
+            m_compiledExceptions.append( exception );
+
+        }
+
+        // resolved settings must be recomputed. Entries are kept, so that each decoration
+        // is connected to the cache cleanup only once
+        for( auto iter = m_cache.begin(); iter != m_cache.end(); ++iter )
+        { iter->settings.clear(); }
+
     }
 
     //__________________________________________________________________
     InternalSettingsPtr SettingsProvider::internalSettings( Decoration *decoration ) const
     {
 
-        QString windowTitle;
-        QString className;
+        // no exceptions
+        if( m_compiledExceptions.isEmpty() ) return m_defaultSettings;
 
         // get the client
         auto client = decoration->client().data();
+        const QString windowTitle( m_hasTitleExceptions ? client->caption() : QString() );
 
-        foreach( auto internalSettings, m_exceptions )
+        // check cache. Settings only need to be resolved again when the caption changed
+        auto iter = m_cache.find( decoration );
+        if( iter == m_cache.end() )
         {
+            iter = m_cache.insert( decoration, CacheEntry() );
+            connect( decoration, &QObject::destroyed, this, [this]( QObject* object ) { m_cache.remove( object ); } );
 
-            // discard disabled exceptions
-            if( !internalSettings->enabled() ) continue;
+        } else if( iter->settings && iter->caption == windowTitle ) return iter->settings;
 
-            // discard exceptions with empty exception pattern
-            if( internalSettings->exceptionPattern().isEmpty() ) continue;
+        iter->caption = windowTitle;
+        iter->settings = m_defaultSettings;
+
+        // retrieve class name
+        if( m_hasClassExceptions && iter->className.isEmpty() )
+        {
+            KWindowInfo info( client->windowId(), nullptr, NET::WM2WindowClass );
+            QString window_className( QString::fromUtf8(info.windowClassName()) );
+            QString window_class( QString::fromUtf8(info.windowClassClass()) );
+            iter->className = window_className + QStringLiteral(" ") + window_class;
+        }
+
+        for( const Exception& exception : m_compiledExceptions )
+        {
 
             /*
             decide which value is to be compared
             to the regular expression, based on exception type
             */
-            QString value;
-            switch( internalSettings->exceptionType() )
-            {
-                case InternalSettings::ExceptionWindowTitle:
-                {
-                    value = windowTitle.isEmpty() ? (windowTitle = client->caption()):windowTitle;
-                    break;
-                }
-
-                default:
-                case InternalSettings::ExceptionWindowClassName:
-                {
-                    if( className.isEmpty() )
-                    {
-                        // retrieve class name
-                        KWindowInfo info( client->windowId(), nullptr, NET::WM2WindowClass );
-                        QString window_className( QString::fromUtf8(info.windowClassName()) );
-                        QString window_class( QString::fromUtf8(info.windowClassClass()) );
-                        className = window_className + QStringLiteral(" ") + window_class;
-                    }
-
-                    value = className;
-                    break;
-                }
-
-            }
+            const QString& value( exception.type == InternalSettings::ExceptionWindowTitle ? windowTitle : iter->className );
 
             // check matching
-            if( QRegExp( internalSettings->exceptionPattern() ).indexIn( value ) >= 0 )
-            { return internalSettings; }
+            if( exception.expression.match( value ).hasMatch() )
+            {
+                iter->settings = exception.settings;
+                break;
+            }
 
         }
 
-        return m_defaultSettings;
+        return iter->settings;
 
     }
 
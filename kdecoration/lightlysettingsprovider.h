@@ -26,7 +26,9 @@
 
 #include <KSharedConfig>
 
+#include <QHash>
 #include <QObject>
+#include <QRegularExpression>
 
 namespace Lightly
 {
@@ -63,6 +65,48 @@ namespace Lightly
         //* exceptions
         InternalSettingsList m_exceptions;
 
+        //* compiled exception
+        class Exception
+        {
+            public:
+
+            //* settings
+            InternalSettingsPtr settings;
+
+            //* exception type
+            int type = InternalSettings::ExceptionWindowClassName;
+
+            //* compiled pattern
+            QRegularExpression expression;
+        };
+
+        //* enabled exceptions with a valid pattern, compiled at reconfigure
+        QList<Exception> m_compiledExceptions;
+
+        //* true if some exception matches against the window title
+        bool m_hasTitleExceptions = false;
+
+        //* true if some exception matches against the window class
+        bool m_hasClassExceptions = false;
+
+        //* resolved settings for a decoration
+        class CacheEntry
+        {
+            public:
+
+            //* caption used to resolve the settings
+            QString caption;
+
+            //* window class, queried from the windowing system at most once
+            QString className;
+
+            //* resolved settings
+            InternalSettingsPtr settings;
+        };
+
+        //* resolved settings, per decoration
+        mutable QHash<const QObject*, CacheEntry> m_cache;
+
         //* config object
         KSharedConfigPtr m_config;
 
@@ -0,0 +1,85 @@
+
+/*************************************************************************
+ * Copyright (C) 2014 by Hugo Pereira Da Costa <hugo.pereira@free.fr>    *
+ *                                                                       *
+ * This program is free software; you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by  *
+ * the Free Software Foundation; either version 2 of the License, or     *
+ * (at your option) any later version.                                   *
+ *                                                                       *
+ * This program is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ * GNU General Public License for more details.                          *
+ *                                                                       *
+ * You should have received a copy of the GNU General Public License     *
+ * along with this program; if not, write to the                         *
+ * Free Software Foundation, Inc.,                                       *
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA .        *
+ *************************************************************************/
+
+#include "lightlyanimationclock.h"
+#include "lightlywidgetstateengine.h"
+
+#include <QTimerEvent>
+#include <QWidget>
+
+#include <algorithm>
+
+namespace Lightly
+{
+
+    //____________________________________________________________
+    void AnimationClock::wake( WidgetStateEngine* engine )
+    {
+
+        if( !engine ) return;
+        if( std::find( _engines.constBegin(), _engines.constEnd(), engine ) == _engines.constEnd() )
+        { _engines.append( engine ); }
+
+        if( !_timer.isActive() )
+        {
+            _elapsed.start();
+            _timer.start( _interval, Qt::PreciseTimer, this );
+        }
+
+    }
+
+    //____________________________________________________________
+    void AnimationClock::remove( WidgetStateEngine* engine )
+    {
+        _engines.erase( std::remove( _engines.begin(), _engines.end(), engine ), _engines.end() );
+        if( _engines.isEmpty() ) _timer.stop();
+    }
+
+    //____________________________________________________________
+    void AnimationClock::timerEvent( QTimerEvent* event )
+    {
+
+        if( event->timerId() != _timer.timerId() )
+        { return QObject::timerEvent( event ); }
+
+        const int elapsed( _elapsed.restart() );
+
+        // advance all engines, and drop the ones that are done
+        // resize, rather than clear, keeps the allocated storage from one tick to the next
+        _dirty.resize( 0 );
+        for( int index = 0; index < _engines.size(); )
+        {
+            WidgetStateEngine* engine( _engines.at( index ).data() );
+            if( engine && engine->advance( elapsed, _dirty ) ) ++index;
+            else _engines.remove( index );
+        }
+
+        // repaint each widget only once, even if several of its animations changed
+        std::sort( _dirty.begin(), _dirty.end() );
+        _dirty.erase( std::unique( _dirty.begin(), _dirty.end() ), _dirty.end() );
+        for( QWidget* widget : qAsConst( _dirty ) )
+        { widget->update(); }
+
+        // sleep
+        if( _engines.isEmpty() ) _timer.stop();
+
+    }
+
+}
@@ -1,5 +1,6 @@
-#ifndef lightlyenable_data_h
-#define lightlyenable_data_h
+#ifndef lightlyanimationclock_h
+#define lightlyanimationclock_h
+
 
 /*************************************************************************
  * Copyright (C) 2014 by Hugo Pereira Da Costa <hugo.pereira@free.fr>    *
@@ -20,13 +21,25 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA .        *
  *************************************************************************/
 
-#include "lightlywidgetstatedata.h"
+#include "lightly.h"
+
+#include <QBasicTimer>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QVector>
 
 namespace Lightly
 {
 
-    //* Enable data
-    class EnableData: public WidgetStateData
+    class WidgetStateEngine;
+
+    //* single frame clock, shared by all widget state engines
+    /**
+    engines register themselves when one of their animations starts.
+    On each tick, running animations are advanced, widgets whose opacity changed are repainted once,
+    and engines with no running animation are dropped. The timer stops when no engine is left.
+    */
+    class AnimationClock: public QObject
     {
 
         Q_OBJECT
@@ -34,12 +47,41 @@ namespace Lightly
         public:
 
         //* constructor
-        EnableData( QObject* parent, QWidget* target, int duration, bool state = true ):
-            WidgetStateData( parent, target, duration, state )
-        { target->installEventFilter( this ); }
+        explicit AnimationClock( QObject* parent ):
+            QObject( parent )
+        {}
+
+        //* make sure given engine is advanced on next ticks
+        void wake( WidgetStateEngine* );
+
+        //* remove engine
+        void remove( WidgetStateEngine* );
+
+        //* true if running
+        bool isRunning() const
+        { return _timer.isActive(); }
+
+        protected:
+
+        //* tick
+        void timerEvent( QTimerEvent* ) override;
+
+        private:
+
+        //* frame interval (ms)
+        static const int _interval = 16;
+
+        //* timer
+        QBasicTimer _timer;
+
+        //* time elapsed since last tick
+        QElapsedTimer _elapsed;
+
+        //* engines with running animations
+        QVector<WeakPointer<WidgetStateEngine>> _engines;
 
-        //* event filter
-        bool eventFilter( QObject*, QEvent* ) override;
+        //* widgets to be repainted at the end of current tick
+        QVector<QWidget*> _dirty;
 
     };
 
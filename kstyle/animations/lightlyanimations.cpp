@@ -44,20 +44,22 @@ namespace Lightly
     Animations::Animations( QObject* parent ):
         QObject( parent )
     {
-        _widgetEnabilityEngine = new WidgetStateEngine( this );
+        _clock = new AnimationClock( this );
+
+        _widgetEnabilityEngine = new WidgetStateEngine( this, _clock );
         _busyIndicatorEngine = new BusyIndicatorEngine( this );
-        _comboBoxEngine = new WidgetStateEngine( this );
-        _toolButtonEngine = new WidgetStateEngine( this );
+        _comboBoxEngine = new WidgetStateEngine( this, _clock );
+        _toolButtonEngine = new WidgetStateEngine( this, _clock );
         _spinBoxEngine = new SpinBoxEngine( this );
         _toolBoxEngine = new ToolBoxEngine( this );
 
         registerEngine( _headerViewEngine = new HeaderViewEngine( this ) );
-        registerEngine( _widgetStateEngine = new WidgetStateEngine( this ) );
-        registerEngine( _inputWidgetEngine = new WidgetStateEngine( this ) );
-        registerEngine( _scrollBarEngine = new ScrollBarEngine( this ) );
+        registerEngine( _widgetStateEngine = new WidgetStateEngine( this, _clock ) );
+        registerEngine( _inputWidgetEngine = new WidgetStateEngine( this, _clock ) );
+        registerEngine( _scrollBarEngine = new ScrollBarEngine( this, _clock ) );
         registerEngine( _stackedWidgetEngine = new StackedWidgetEngine( this ) );
         registerEngine( _tabBarEngine = new TabBarEngine( this ) );
-        registerEngine( _dialEngine = new DialEngine( this ) );
+        registerEngine( _dialEngine = new DialEngine( this, _clock ) );
 
     }
 
@@ -94,6 +96,7 @@ namespace Lightly
 
         // stacked widget transition has an extra flag for animations
         _stackedWidgetEngine->setEnabled( animationsEnabled && StyleConfigData::stackedWidgetTransitionsEnabled() );
+        _stackedWidgetEngine->setMaxPixels( qint64( StyleConfigData::stackedWidgetTransitionsMaxPixels() )*1000 );
 
         // busy indicator
         _busyIndicatorEngine->setEnabled( StyleConfigData::progressBarAnimated() );
@@ -206,7 +209,7 @@ namespace Lightly
         _widgetEnabilityEngine->unregisterWidget( widget );
         _spinBoxEngine->unregisterWidget( widget );
         _comboBoxEngine->unregisterWidget( widget );
-        _busyIndicatorEngine->registerWidget( widget );
+        _busyIndicatorEngine->unregisterWidget( widget );
 
         // the following allows some optimization of widget unregistration
         // it assumes that a widget can be registered atmost in one of the
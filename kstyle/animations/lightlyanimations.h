@@ -20,6 +20,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA .        *
  *************************************************************************/
 
+#include "lightlyanimationclock.h"
 #include "lightlybusyindicatorengine.h"
 #include "lightlydialengine.h"
 #include "lightlyheaderviewengine.h"
@@ -113,6 +114,9 @@ namespace Lightly
         //* register new engine
         void registerEngine( BaseEngine* );
 
+        //* frame clock, shared by widget state engines
+        AnimationClock* _clock = nullptr;
+
         //* busy indicator
         BusyIndicatorEngine* _busyIndicatorEngine = nullptr;
 
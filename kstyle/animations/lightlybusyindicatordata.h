@@ -21,6 +21,7 @@
  *************************************************************************/
 
 #include <QObject>
+#include <QRect>
 
 namespace Lightly
 {
@@ -33,9 +34,10 @@ namespace Lightly
         public:
 
         //* constructor
-        explicit BusyIndicatorData( QObject* parent ):
+        explicit BusyIndicatorData( QObject* parent, bool quickItem = false ):
             QObject( parent ),
-            _animated( false )
+            _animated( false ),
+            _quickItem( quickItem )
         {}
 
         //* destructor
@@ -49,6 +51,14 @@ namespace Lightly
         bool isAnimated() const
         { return _animated; }
 
+        //* true if target is a QtQuickControls style item
+        bool isQuickItem() const
+        { return _quickItem; }
+
+        //* progress contents rect, in target coordinates
+        const QRect& contentsRect() const
+        { return _contentsRect; }
+
         //@}
 
         //*@name modifiers
@@ -66,6 +76,10 @@ namespace Lightly
         void setAnimated( bool value )
         { _animated = value; }
 
+        //* contents rect
+        void setContentsRect( const QRect& rect )
+        { _contentsRect = rect; }
+
         //@}
 
         private:
@@ -73,6 +87,12 @@ namespace Lightly
         //* animated
         bool _animated;
 
+        //* quick item
+        bool _quickItem;
+
+        //* contents rect
+        QRect _contentsRect;
+
     };
 
 }
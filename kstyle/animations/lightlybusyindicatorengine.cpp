@@ -21,7 +21,12 @@
 
 #include "lightly.h"
 
+#include <QGuiApplication>
+#include <QScreen>
+#include <QTimerEvent>
+#include <QtMath>
 #include <QVariant>
+#include <QWidget>
 
 namespace Lightly
 {
@@ -41,7 +46,8 @@ namespace Lightly
          // create new data class
         if( !_data.contains( object ) )
         {
-            _data.insert( object, new BusyIndicatorData( this ) );
+            // QtQuickControls items are identified once, rather than at every tick
+            _data.insert( object, new BusyIndicatorData( this, object->inherits( "QQuickStyleItem" ) ) );
 
             // connect destruction signal
             connect( object, SIGNAL(destroyed(QObject*)), this, SLOT(unregisterWidget(QObject*)), Qt::UniqueConnection );
@@ -67,9 +73,12 @@ namespace Lightly
         if( duration() == value ) return;
         BaseEngine::setDuration( value );
 
-        // restart timer with specified time
-        if( _animation )
-        { _animation.data()->setDuration( value ); }
+        // restart timer with updated interval
+        if( _timer.isActive() )
+        {
+            _timer.stop();
+            start();
+        }
 
     }
 
@@ -84,82 +93,76 @@ namespace Lightly
             data.data()->setAnimated( value );
 
             // start timer if needed
-            if( value )
-            {
-                if( !_animation )
-                {
+            // this is called from paint events, so that targets becoming visible again resume ticking
+            if( value ) start();
 
-                    // create animation if not already there
-                    _animation = new Animation( duration(), this );
-
-                    // setup
-                    _animation.data()->setStartValue( 0 );
-                    _animation.data()->setEndValue( 2*Metrics::ProgressBar_BusyIndicatorSize );
-                    _animation.data()->setTargetObject( this );
-                    _animation.data()->setPropertyName( "value" );
-                    _animation.data()->setLoopCount( -1 );
-                    _animation.data()->setDuration( duration() );
-
-                }
+        }
 
-                // start if  not already running
-                if( !_animation.data()->isRunning() )
-                { _animation.data()->start(); }
+    }
 
-            }
+    //____________________________________________________________
+    void BusyIndicatorEngine::setContentsRect( const QObject* object, const QRect& rect )
+    {
 
-        }
+        DataMap<BusyIndicatorData>::Value data( BusyIndicatorEngine::data( object ) );
+        if( data ) data.data()->setContentsRect( rect );
 
-        
     }
 
-
     //____________________________________________________________
     DataMap<BusyIndicatorData>::Value BusyIndicatorEngine::data( const QObject* object )
     { return _data.find( object ).data(); }
 
-    //_______________________________________________
-    void BusyIndicatorEngine::setValue( int value )
+    //____________________________________________________________
+    void BusyIndicatorEngine::timerEvent( QTimerEvent* event )
     {
 
-        // update
+        if( event->timerId() != _timer.timerId() ) return BaseEngine::timerEvent( event );
+
+        // compute value from elapsed time, so that skipped ticks do not slow down the animation
+        const int period( qMax( 1, duration() ) );
+        const int value( ( _clock.elapsed() % period )*2*Metrics::ProgressBar_BusyIndicatorSize/period );
+        if( value == _value ) return;
         _value = value;
 
-        bool animated( false );
+        bool visible( false );
 
         // loop over objects in map
         for( DataMap<BusyIndicatorData>::iterator iter = _data.begin(); iter != _data.end(); ++iter )
         {
 
-            if( iter.value().data()->isAnimated() )
+            const BusyIndicatorData* data( iter.value().data() );
+            if( !( data && data->isAnimated() ) ) continue;
+
+            QObject* object( const_cast<QObject*>( iter.key() ) );
+            if( data->isQuickItem() )
             {
 
-                // update animation flag
-                animated = true;
+                //QtQuickControls "rerender" method is updateItem
+                visible = true;
+                QMetaObject::invokeMethod( object, "updateItem", Qt::QueuedConnection );
 
-                // emit update signal on object
-                if( const_cast<QObject*>( iter.key() )->inherits( "QQuickStyleItem" ))
-                {
+            } else if( QWidget* widget = qobject_cast<QWidget*>( object ) ) {
 
-                    //QtQuickControls "rerender" method is updateItem
-                    QMetaObject::invokeMethod( const_cast<QObject*>( iter.key() ), "updateItem", Qt::QueuedConnection);
+                // skip hidden, clipped out and minimized targets
+                if( !isVisible( widget ) ) continue;
+                visible = true;
 
-                } else {
+                // only repaint progress contents when known
+                if( data->contentsRect().isValid() ) widget->update( data->contentsRect() );
+                else widget->update();
 
-                    QMetaObject::invokeMethod( const_cast<QObject*>( iter.key() ), "update", Qt::QueuedConnection);
+            } else {
 
-                }
+                visible = true;
+                QMetaObject::invokeMethod( object, "update", Qt::QueuedConnection );
 
             }
 
         }
 
-        if( _animation && !animated )
-        {
-            _animation.data()->stop();
-            _animation.data()->deleteLater();
-            _animation.clear();
-        }
+        // pause when nothing visible is left. Ticking resumes on next paint
+        if( !visible ) stop();
 
     }
 
@@ -167,14 +170,48 @@ namespace Lightly
     bool BusyIndicatorEngine::unregisterWidget( QObject* object )
     {
         const bool removed( _data.unregisterWidget( object ) );
-        if( _animation && _data.isEmpty() )
-        {
-            _animation.data()->stop();
-            _animation.data()->deleteLater();
-            _animation.clear();
-        }
-
+        if( _data.isEmpty() ) stop();
         return removed;
     }
 
+    //__________________________________________________________
+    void BusyIndicatorEngine::start()
+    {
+        if( _timer.isActive() ) return;
+        if( !_clock.isValid() ) _clock.start();
+        _timer.start( interval(), Qt::PreciseTimer, this );
+    }
+
+    //__________________________________________________________
+    void BusyIndicatorEngine::stop()
+    { _timer.stop(); }
+
+    //__________________________________________________________
+    int BusyIndicatorEngine::interval() const
+    {
+
+        // no need to tick faster than the displayed value changes
+        const int steps( 2*Metrics::ProgressBar_BusyIndicatorSize );
+        const int stepInterval( qMax( 1, duration() )/steps );
+
+        // nor faster than the display refreshes
+        const QScreen* screen( QGuiApplication::primaryScreen() );
+        const qreal refreshRate( ( screen && screen->refreshRate() > 0 ) ? screen->refreshRate() : 60 );
+        const int frameInterval( qCeil( 1000/refreshRate ) );
+
+        return qMax( stepInterval, frameInterval );
+
+    }
+
+    //__________________________________________________________
+    bool BusyIndicatorEngine::isVisible( const QWidget* widget )
+    {
+        if( !widget->isVisible() ) return false;
+
+        const QWidget* window( widget->window() );
+        if( window->isMinimized() ) return false;
+
+        return !widget->visibleRegion().isEmpty();
+    }
+
 }
@@ -20,11 +20,13 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA .        *
  *************************************************************************/
 
-#include "lightlyanimation.h"
 #include "lightlybaseengine.h"
 #include "lightlybusyindicatordata.h"
 #include "lightlydatamap.h"
 
+#include <QBasicTimer>
+#include <QElapsedTimer>
+
 namespace Lightly
 {
 
@@ -34,9 +36,6 @@ namespace Lightly
 
         Q_OBJECT
 
-        //* declare opacity property
-        Q_PROPERTY( int value READ value WRITE setValue )
-
         public:
 
         //* constructor
@@ -66,8 +65,8 @@ namespace Lightly
         //* set object as animated
         void setAnimated( const QObject*, bool );
 
-        //* opacity
-        void setValue( int value );
+        //* set progress contents rect, used to limit repaints
+        void setContentsRect( const QObject*, const QRect& );
 
         //@}
 
@@ -81,13 +80,31 @@ namespace Lightly
         //* returns data associated to widget
         DataMap<BusyIndicatorData>::Value data( const QObject* );
 
+        //* timer event
+        void timerEvent( QTimerEvent* ) override;
+
         private:
 
+        //* start ticking, if not already running
+        void start();
+
+        //* stop ticking
+        void stop();
+
+        //* tick interval (msec), bound to display refresh rate
+        int interval() const;
+
+        //* true if widget can actually be seen on screen
+        static bool isVisible( const QWidget* );
+
         //* map widgets to progressbar data
         DataMap<BusyIndicatorData> _data;
 
-        //* animation
-        Animation::Pointer _animation;
+        //* tick timer
+        QBasicTimer _timer;
+
+        //* elapsed time since ticking started
+        QElapsedTimer _clock;
 
         //* value
         int _value = 0;
@@ -35,8 +35,8 @@ namespace Lightly
         public:
 
         //* constructor
-        explicit DialEngine( QObject* parent ):
-            WidgetStateEngine( parent )
+        explicit DialEngine( QObject* parent, AnimationClock* clock ):
+            WidgetStateEngine( parent, clock )
         {}
 
         //* destructor
@@ -35,8 +35,8 @@ namespace Lightly
         public:
 
         //* constructor
-        explicit ScrollBarEngine( QObject* parent ):
-            WidgetStateEngine( parent )
+        explicit ScrollBarEngine( QObject* parent, AnimationClock* clock ):
+            WidgetStateEngine( parent, clock )
         {}
 
         //* destructor
@@ -42,7 +42,6 @@ namespace Lightly
 
         // disable focus
         transition().data()->setAttribute(Qt::WA_NoMousePropagation, true);
-        transition().data()->setFlag(TransitionWidget::PaintOnWidget, true);
 
         setMaxRenderTime( 50 );
 
@@ -72,12 +71,21 @@ namespace Lightly
         if( QWidget *widget = _target.data()->widget( _index ) )
         {
 
+            _index = _target.data()->currentIndex();
+
+            // only grab the part of the previous page that can be seen,
+            // e.g. when the stack is embedded in a scrollarea
+            const QRect rect( widget->geometry() & visibleRect() );
+            if( rect.isEmpty() ) return false;
+
+            // skip transition when grabbing would be too expensive
+            if( _maxPixels > 0 && qint64( rect.width() )*rect.height() > _maxPixels ) return false;
+
             transition().data()->setOpacity( 0 );
             startClock();
-            transition().data()->setGeometry( widget->geometry() );
-            transition().data()->setStartPixmap( transition().data()->grab( widget ) );
+            transition().data()->setGeometry( rect );
+            transition().data()->setStartPixmap( transition().data()->grab( widget, rect.translated( -widget->pos() ) ) );
 
-            _index = _target.data()->currentIndex();
             return !slow();
 
         } else {
@@ -129,6 +137,21 @@ namespace Lightly
 
     }
 
+    //___________________________________________________________________
+    QRect StackedWidgetData::visibleRect() const
+    {
+
+        QRect rect( _target.data()->rect() );
+        for( QWidget* parent = _target.data()->parentWidget(); parent; parent = parent->parentWidget() )
+        {
+            rect &= QRect( _target.data()->mapFrom( parent, QPoint( 0, 0 ) ), parent->size() );
+            if( parent->isWindow() ) break;
+        }
+
+        return rect;
+
+    }
+
     //___________________________________________________________________
     void StackedWidgetData::targetDestroyed()
     {
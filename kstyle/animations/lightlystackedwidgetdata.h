@@ -45,6 +45,10 @@ namespace Lightly
         //* constructor
         StackedWidgetData( QObject*, QStackedWidget*, int );
 
+        //* largest area that can be grabbed for transitions. 0 means no limit
+        void setMaxPixels( qint64 value )
+        { _maxPixels = value; }
+
         protected Q_SLOTS:
 
         //* initialize animation
@@ -61,12 +65,18 @@ namespace Lightly
 
         private:
 
+        //* part of the target that is not clipped by its parents, in target coordinates
+        QRect visibleRect() const;
+
         //* target
         WeakPointer<QStackedWidget> _target;
 
         //* current index
         int _index;
 
+        //* largest area that can be grabbed for transitions
+        qint64 _maxPixels = 0;
+
     };
 
 }
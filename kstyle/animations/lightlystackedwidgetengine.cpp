@@ -34,7 +34,12 @@ namespace Lightly
     {
 
         if( !widget ) return false;
-        if( !_data.contains( widget ) ) { _data.insert( widget, new StackedWidgetData( this, widget, duration() ), enabled() ); }
+        if( !_data.contains( widget ) )
+        {
+            auto data( new StackedWidgetData( this, widget, duration() ) );
+            data->setMaxPixels( _maxPixels );
+            _data.insert( widget, data, enabled() );
+        }
 
         // connect destruction signal
         disconnect( widget, SIGNAL(destroyed(QObject*)), this, SLOT(unregisterWidget(QObject*)) );
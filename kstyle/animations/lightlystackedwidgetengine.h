@@ -64,6 +64,14 @@ namespace Lightly
             _data.setDuration( value );
         }
 
+        //* largest area that can be grabbed for transitions
+        void setMaxPixels( qint64 value )
+        {
+            _maxPixels = value;
+            foreach( const DataMap<StackedWidgetData>::Value& data, _data )
+            { if( data ) data.data()->setMaxPixels( value ); }
+        }
+
         public Q_SLOTS:
 
         //* remove widget from map
@@ -75,6 +83,9 @@ namespace Lightly
         //* maps
         DataMap<StackedWidgetData> _data;
 
+        //* largest area that can be grabbed for transitions
+        qint64 _maxPixels = 0;
+
     };
 
 }
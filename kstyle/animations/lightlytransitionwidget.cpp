@@ -126,77 +126,33 @@ namespace Lightly
         QRect rect = event->rect();
         if( !rect.isValid() ) rect = this->rect();
 
-        // local pixmap
-        const bool paintOnWidget( testFlag( PaintOnWidget ) && !testFlag( Transparent ) );
-        if( !paintOnWidget )
+        // pixmaps are faded using painter opacity, directly on the widget.
+        // Since composition is associative, this matches blending both pixmaps in an intermediate buffer first,
+        // without allocating and clearing one at every frame
+        QPainter p( this );
+        p.setClipRect( rect );
+
+        // draw end pixmap first, provided that opacity is large enough
+        if( opacity() >= 0.004 && !_endPixmap.isNull() )
         {
 
-            if( _currentPixmap.isNull() || _currentPixmap.size() != size() )
-            { _currentPixmap = QPixmap( size() ); }
+            // faded endPixmap if parent target is transparent
+            if( opacity() <= 0.996 && testFlag( Transparent ) ) p.setOpacity( opacity() );
+            p.drawPixmap( QPoint(), _endPixmap );
 
         }
 
-        // fill
-        _currentPixmap.fill( Qt::transparent );
-
-        // copy local pixmap to current
+        // draw fading start pixmap
+        if( opacity() <= 0.996 && !_startPixmap.isNull() )
         {
 
-            QPainter p;
-
-            // draw end pixmap first, provided that opacity is small enough
-            if( opacity() >= 0.004 && !_endPixmap.isNull() )
-            {
-
-                // faded endPixmap if parent target is transparent and opacity is
-                if( opacity() <= 0.996 && testFlag( Transparent ) )
-                {
-
-                    fade( _endPixmap, _currentPixmap, opacity(), rect );
-                    p.begin( &_currentPixmap );
-                    p.setClipRect( event->rect() );
-
-                } else {
-
-                    if( paintOnWidget ) p.begin( this );
-                    else p.begin( &_currentPixmap );
-                    p.setClipRect( event->rect() );
-                    p.drawPixmap( QPoint(), _endPixmap );
-
-                }
+            p.setOpacity( opacity() >= 0.004 ? 1.0 - opacity() : 1.0 );
+            p.drawPixmap( QPoint(), _startPixmap );
 
-            } else {
-
-                if( paintOnWidget ) p.begin( this );
-                else p.begin( &_currentPixmap );
-                p.setClipRect( event->rect() );
-
-            }
-
-            // draw fading start pixmap
-            if( opacity() <= 0.996 && !_startPixmap.isNull() )
-            {
-                if( opacity() >= 0.004 )
-                {
-
-                    fade( _startPixmap, _localStartPixmap, 1.0-opacity(), rect );
-                    p.drawPixmap( QPoint(), _localStartPixmap );
-
-                } else p.drawPixmap( QPoint(), _startPixmap );
-
-            }
-
-            p.end();
         }
 
-        // copy current pixmap on widget
-        if( !paintOnWidget )
-        {
-            QPainter p( this );
-            p.setClipRect( event->rect() );
-            p.drawPixmap( QPoint(0,0), _currentPixmap );
-            p.end();
-        }
+        p.end();
+
     }
 
     //________________________________________________
@@ -227,13 +183,14 @@ namespace Lightly
         if( !parent ) parent = widget;
 
         // painting
+        // rect is in widget coordinates, and may not start at the origin, while pixmap starts at rect's top left corner
         QPainter p(&pixmap);
-        p.setClipRect( rect );
+        p.setClipRect( pixmap.rect() );
         const QBrush backgroundBrush = parent->palette().brush( parent->backgroundRole());
         if( backgroundBrush.style() == Qt::TexturePattern)
         {
 
-            p.drawTiledPixmap( rect, backgroundBrush.texture(), widget->mapTo( parent, rect.topLeft() ) );
+            p.drawTiledPixmap( pixmap.rect(), backgroundBrush.texture(), widget->mapTo( parent, rect.topLeft() ) );
 
         } else {
 
@@ -245,8 +202,7 @@ namespace Lightly
         {
             QStyleOption option;
             option.initFrom(parent);
-            option.rect = rect;
-            option.rect.translate( widget->mapTo( parent, rect.topLeft() ) );
+            option.rect = QRect( widget->mapTo( parent, rect.topLeft() ), rect.size() );
             p.translate(-option.rect.topLeft());
             parent->style()->drawPrimitive ( QStyle::PE_Widget, &option, &p, parent );
             p.translate(option.rect.topLeft());
@@ -254,11 +210,10 @@ namespace Lightly
 
         // draw all widgets in parent list
         // backward
-        QPaintEvent event(rect);
         for( int i = widgets.size() - 1; i>=0; i-- )
         {
             QWidget* w = widgets.at(i);
-            w->render( &p, -widget->mapTo( w, rect.topLeft() ), rect, nullptr );
+            w->render( &p, QPoint(), QRect( widget->mapTo( w, rect.topLeft() ), rect.size() ), nullptr );
         }
 
         // end
@@ -270,35 +225,4 @@ namespace Lightly
     void TransitionWidget::grabWidget( QPixmap& pixmap, QWidget* widget, QRect& rect ) const
     { widget->render( &pixmap, pixmap.rect().topLeft(), rect, QWidget::DrawChildren ); }
 
-    //________________________________________________
-    void TransitionWidget::fade( const QPixmap& source, QPixmap& target, qreal opacity, const QRect& rect ) const
-    {
-
-        if( target.isNull() || target.size() != size() )
-        { target = QPixmap( size() ); }
-
-        // erase target
-        target.fill( Qt::transparent );
-
-        // check opacity
-        if( opacity*255 < 1 ) return;
-
-        QPainter p( &target );
-        p.setClipRect( rect );
-
-        // draw pixmap
-        p.drawPixmap( QPoint(0,0), source );
-
-        // opacity mask (0.996 corresponds to 254/255)
-        if( opacity <= 0.996 )
-        {
-            p.setCompositionMode(QPainter::CompositionMode_DestinationIn);
-            QColor color( Qt::black );
-            color.setAlphaF( opacity );
-            p.fillRect(rect, color );
-        }
-
-        p.end();
-   }
-
 }
@@ -59,8 +59,7 @@ namespace Lightly
         {
             None = 0,
             GrabFromWindow = 1<<0,
-            Transparent = 1<<1,
-            PaintOnWidget = 1<<2
+            Transparent = 1<<1
         };
 
         Q_DECLARE_FLAGS(Flags, Flag)
@@ -131,19 +130,12 @@ namespace Lightly
 
         //* end
         void setEndPixmap( QPixmap pixmap )
-        {
-            _endPixmap = pixmap;
-            _currentPixmap = pixmap;
-        }
+        { _endPixmap = pixmap; }
 
         //* start
         const QPixmap& endPixmap() const
         { return _endPixmap; }
 
-        //* current
-        const QPixmap& currentPixmap() const
-        { return _currentPixmap; }
-
         //@}
 
         //* grap pixmap
@@ -186,9 +178,6 @@ namespace Lightly
         //* grab widget
         void grabWidget( QPixmap&, QWidget*, QRect& ) const;
 
-        //* fade pixmap
-        void fade( const QPixmap& source, QPixmap& target, qreal opacity, const QRect& ) const;
-
         //* apply step
         qreal digitize( const qreal& value ) const
         {
@@ -210,15 +199,9 @@ namespace Lightly
         //* animation starting pixmap
         QPixmap _startPixmap;
 
-        //* animation starting pixmap
-        QPixmap _localStartPixmap;
-
-        //* animation starting pixmap
+        //* animation ending pixmap
         QPixmap _endPixmap;
 
-        //* current pixmap
-        QPixmap _currentPixmap;
-
         //* current state opacity
         qreal _opacity = 0;
 
@@ -19,21 +19,57 @@
  *************************************************************************/
 
 #include "lightlywidgetstateengine.h"
+#include "lightlystyleconfigdata.h"
 
-#include "lightlyenabledata.h"
+#include <QEvent>
+
+#include <algorithm>
 
 namespace Lightly
 {
 
+    //____________________________________________________________
+    static const QEasingCurve& easingCurve( QEasingCurve::Type type )
+    {
+        static const QEasingCurve inQuint( QEasingCurve::InQuint );
+        static const QEasingCurve outQuint( QEasingCurve::OutQuint );
+        static const QEasingCurve outBack( QEasingCurve::OutBack );
+        switch( type )
+        {
+            case QEasingCurve::OutQuint: return outQuint;
+            case QEasingCurve::OutBack: return outBack;
+            default: return inQuint;
+        }
+    }
+
+    //____________________________________________________________
+    int& WidgetStateEngine::SlotIndices::at( AnimationMode mode )
+    {
+        switch( mode )
+        {
+            default:
+            case AnimationHover: return hover;
+            case AnimationFocus: return focus;
+            case AnimationEnable: return enable;
+            case AnimationPressed: return pressed;
+        }
+    }
+
     //____________________________________________________________
     bool WidgetStateEngine::registerWidget( QWidget* widget, AnimationModes mode )
     {
 
         if( !widget ) return false;
-        if( mode&AnimationHover && !_hoverData.contains( widget ) ) { _hoverData.insert( widget, new WidgetStateData( this, widget, duration() ), enabled() ); }
-        if( mode&AnimationFocus && !_focusData.contains( widget ) ) { _focusData.insert( widget, new WidgetStateData( this, widget, duration() ), enabled() ); }
-        if( mode&AnimationEnable && !_enableData.contains( widget ) ) { _enableData.insert( widget, new EnableData( this, widget, duration() ), enabled() ); }
-        if( mode&AnimationPressed && !_pressedData.contains( widget ) ) { _pressedData.insert( widget, new WidgetStateData( this, widget, duration() ), enabled() ); }
+
+        SlotIndices& indices( _slotIndices[widget] );
+        if( mode&AnimationHover && indices.hover < 0 ) { indices.hover = allocateSlot( widget, duration(), false ); }
+        if( mode&AnimationFocus && indices.focus < 0 ) { indices.focus = allocateSlot( widget, duration(), false ); }
+        if( mode&AnimationEnable && indices.enable < 0 )
+        {
+            indices.enable = allocateSlot( widget, duration(), true );
+            widget->installEventFilter( this );
+        }
+        if( mode&AnimationPressed && indices.pressed < 0 ) { indices.pressed = allocateSlot( widget, duration(), false ); }
 
         // connect destruction signal
         connect( widget, SIGNAL(destroyed(QObject*)), this, SLOT(unregisterWidget(QObject*)), Qt::UniqueConnection );
@@ -42,6 +78,75 @@ namespace Lightly
 
     }
 
+    //____________________________________________________________
+    bool WidgetStateEngine::unregisterWidget( QObject* object )
+    {
+
+        if( !object ) return false;
+        bool found = false;
+
+        auto iter( _slotIndices.find( object ) );
+        if( iter != _slotIndices.end() )
+        {
+            const SlotIndices indices( iter.value() );
+            _slotIndices.erase( iter );
+
+            if( indices.enable >= 0 ) object->removeEventFilter( this );
+            for( int index : { indices.hover, indices.focus, indices.enable, indices.pressed } )
+            { if( index >= 0 ) releaseSlot( index ); }
+
+            found = true;
+        }
+
+        if( _hoverData.unregisterWidget( object ) ) found = true;
+        if( _focusData.unregisterWidget( object ) ) found = true;
+        if( _enableData.unregisterWidget( object ) ) found = true;
+        if( _pressedData.unregisterWidget( object ) ) found = true;
+        return found;
+
+    }
+
+    //____________________________________________________________
+    void WidgetStateEngine::setEnabled( bool value )
+    {
+        BaseEngine::setEnabled( value );
+        _hoverData.setEnabled( value );
+        _focusData.setEnabled( value );
+        _enableData.setEnabled( value );
+        _pressedData.setEnabled( value );
+
+        // stop running animations
+        if( !value )
+        {
+            for( int index : qAsConst( _runningSlots ) )
+            { _slots[index].running = false; }
+
+            _runningSlots.clear();
+            if( _clock ) _clock.data()->remove( this );
+        }
+
+    }
+
+    //____________________________________________________________
+    void WidgetStateEngine::setDuration( int value )
+    {
+        BaseEngine::setDuration( value );
+        _hoverData.setDuration( value );
+        _focusData.setDuration( value );
+        _enableData.setDuration( value );
+        _pressedData.setDuration( value/2 );
+
+        for( auto iter = _slotIndices.begin(); iter != _slotIndices.end(); ++iter )
+        {
+            const SlotIndices& indices( iter.value() );
+            if( indices.hover >= 0 ) _slots[indices.hover].duration = value;
+            if( indices.focus >= 0 ) _slots[indices.focus].duration = value;
+            if( indices.enable >= 0 ) _slots[indices.enable].duration = value;
+            if( indices.pressed >= 0 ) _slots[indices.pressed].duration = value/2;
+        }
+
+    }
+
     //____________________________________________________________
     BaseEngine::WidgetList WidgetStateEngine::registeredWidgets( AnimationModes mode ) const
     {
@@ -50,6 +155,16 @@ namespace Lightly
 
         using Value = DataMap<WidgetStateData>::Value;
 
+        for( auto iter = _slotIndices.constBegin(); iter != _slotIndices.constEnd(); ++iter )
+        {
+            const SlotIndices& indices( iter.value() );
+            if( ( (mode&AnimationHover) && indices.hover >= 0 ) ||
+                ( (mode&AnimationFocus) && indices.focus >= 0 ) ||
+                ( (mode&AnimationEnable) && indices.enable >= 0 ) ||
+                ( (mode&AnimationPressed) && indices.pressed >= 0 ) )
+            { out.insert( static_cast<QWidget*>( const_cast<QObject*>( iter.key() ) ) ); }
+        }
+
         if( mode&AnimationHover )
         {
             foreach( const Value& value, _hoverData )
@@ -81,19 +196,177 @@ namespace Lightly
     //____________________________________________________________
     bool WidgetStateEngine::updateState( const QObject* object, AnimationMode mode, bool value, AnimationParameters parameters )
     {
-        DataMap<WidgetStateData>::Value data( WidgetStateEngine::data( object, mode ) );
-        return ( data && data.data()->updateState( value, parameters ) );
+
+        if( !enabled() ) return false;
+
+        AnimationSlot* slot( this->slot( object, mode ) );
+        if( !slot )
+        {
+            DataMap<WidgetStateData>::Value data( WidgetStateEngine::data( object, mode ) );
+            return ( data && data.data()->updateState( value, parameters ) );
+        }
+
+        if( !slot->initialized )
+        {
+
+            slot->state = value;
+            slot->initialized = true;
+            return false;
+
+        } else if( slot->state == value ) {
+
+            return false;
+
+        }
+
+        slot->state = value;
+        slot->forward = ( parameters & AnimationForwardOnly ) ? true : slot->state;
+        if( parameters & AnimationOutBack ) slot->easing = slot->state ? QEasingCurve::OutBack : QEasingCurve::InQuint;
+        else slot->easing = ( parameters & AnimationForwardOnly ) ? QEasingCurve::OutQuint : slot->state ? QEasingCurve::OutQuint : QEasingCurve::InQuint;
+
+        if( parameters & AnimationLongDuration ) slot->duration = StyleConfigData::animationsDuration()*3; //FIXME find a better way to set the duration
+
+        if( !slot->running || ( slot->state && ( parameters & AnimationForwardOnly ) ) )
+        {
+
+            // (re)start from the end matching current direction
+            slot->currentTime = slot->forward ? 0 : slot->duration;
+            if( !slot->running && slot->duration > 0 )
+            {
+                slot->running = true;
+                _runningSlots.append( int( slot - _slots.data() ) );
+                if( _clock ) _clock.data()->wake( this );
+            }
+
+        }
+
+        updateOpacity( *slot );
+        return true;
+
     }
 
     //____________________________________________________________
     bool WidgetStateEngine::isAnimated( const QObject* object, AnimationMode mode )
     {
 
+        if( const AnimationSlot* slot = this->slot( object, mode ) )
+        { return slot->running; }
+
         DataMap<WidgetStateData>::Value data( WidgetStateEngine::data( object, mode ) );
         return ( data && data.data()->animation() && data.data()->animation().data()->isRunning() );
 
     }
 
+    //____________________________________________________________
+    qreal WidgetStateEngine::currentOpacity( const QObject* object, AnimationMode mode )
+    {
+
+        if( const AnimationSlot* slot = this->slot( object, mode ) )
+        { return slot->opacity; }
+
+        return data( object, mode ).data()->opacity();
+
+    }
+
+    //____________________________________________________________
+    bool WidgetStateEngine::advance( int elapsed, QVector<QWidget*>& dirty )
+    {
+
+        for( int position = 0; position < _runningSlots.size(); )
+        {
+
+            AnimationSlot& slot( _slots[_runningSlots.at( position )] );
+            slot.currentTime += slot.forward ? elapsed : -elapsed;
+            if( slot.forward ? slot.currentTime >= slot.duration : slot.currentTime <= 0 )
+            {
+                slot.currentTime = slot.forward ? slot.duration : 0;
+                slot.running = false;
+            }
+
+            const qreal opacity( slot.opacity );
+            updateOpacity( slot );
+
+            // finished animations always trigger a last repaint, for the widget to render its final state
+            if( slot.target && ( slot.opacity != opacity || !slot.running ) )
+            { dirty.append( slot.target ); }
+
+            if( slot.running ) ++position;
+            else _runningSlots.remove( position );
+
+        }
+
+        return !_runningSlots.isEmpty();
+
+    }
+
+    //____________________________________________________________
+    bool WidgetStateEngine::eventFilter( QObject* object, QEvent* event )
+    {
+
+        if( event->type() == QEvent::EnabledChange && enabled() )
+        {
+            if( QWidget* widget = qobject_cast<QWidget*>( object ) )
+            { updateState( widget, AnimationEnable, widget->isEnabled() ); }
+        }
+
+        return BaseEngine::eventFilter( object, event );
+
+    }
+
+    //____________________________________________________________
+    WidgetStateEngine::AnimationSlot* WidgetStateEngine::slot( const QObject* object, AnimationMode mode )
+    {
+
+        if( !( enabled() && object ) ) return nullptr;
+
+        auto iter( _slotIndices.find( object ) );
+        if( iter == _slotIndices.end() ) return nullptr;
+
+        const int index( iter.value().at( mode ) );
+        return index >= 0 ? &_slots[index] : nullptr;
+
+    }
+
+    //____________________________________________________________
+    int WidgetStateEngine::allocateSlot( QWidget* widget, int duration, bool state )
+    {
+
+        AnimationSlot slot;
+        slot.target = widget;
+        slot.duration = duration;
+        slot.state = state;
+
+        if( !_freeSlots.isEmpty() )
+        {
+            const int index( _freeSlots.takeLast() );
+            _slots[index] = slot;
+            return index;
+        }
+
+        _slots.append( slot );
+        return _slots.size() - 1;
+
+    }
+
+    //____________________________________________________________
+    void WidgetStateEngine::releaseSlot( int index )
+    {
+
+        if( _slots.at( index ).running )
+        { _runningSlots.erase( std::remove( _runningSlots.begin(), _runningSlots.end(), index ), _runningSlots.end() ); }
+
+        _slots[index] = AnimationSlot();
+        _freeSlots.append( index );
+
+    }
+
+    //____________________________________________________________
+    void WidgetStateEngine::updateOpacity( AnimationSlot& slot )
+    {
+        const qreal progress( slot.duration > 0 ? qreal( slot.currentTime )/slot.duration : ( slot.forward ? 1.0 : 0.0 ) );
+        slot.opacity = easingCurve( slot.easing ).valueForProgress( progress );
+    }
+
     //____________________________________________________________
     DataMap<WidgetStateData>::Value WidgetStateEngine::data( const QObject* object, AnimationMode mode )
     {
@@ -21,14 +21,24 @@
  *************************************************************************/
 
 #include "lightly.h"
+#include "lightlyanimationclock.h"
 #include "lightlybaseengine.h"
 #include "lightlydatamap.h"
 #include "lightlywidgetstatedata.h"
 
+#include <QEasingCurve>
+#include <QHash>
+#include <QVector>
+
 namespace Lightly
 {
 
     //* used for simple widgets
+    /**
+    hover, focus, enable and pressed animations of widgets registered via registerWidget
+    are stored as plain slots, advanced by the shared AnimationClock, rather than one QObject and QPropertyAnimation each.
+    Derived engines that need richer per widget data still store it in the data maps.
+    */
     class WidgetStateEngine: public BaseEngine
     {
 
@@ -37,8 +47,9 @@ namespace Lightly
         public:
 
         //* constructor
-        explicit WidgetStateEngine( QObject* parent ):
-            BaseEngine( parent )
+        explicit WidgetStateEngine( QObject* parent, AnimationClock* clock ):
+            BaseEngine( parent ),
+            _clock( clock )
         {}
 
         //* register widget
@@ -57,7 +68,7 @@ namespace Lightly
 
         //* animation opacity
         qreal opacity( const QObject* object, AnimationMode mode )
-        { return isAnimated( object, mode ) ? data( object, mode ).data()->opacity(): AnimationData::OpacityInvalid; }
+        { return isAnimated( object, mode ) ? currentOpacity( object, mode ): AnimationData::OpacityInvalid; }
 
         //* animation mode
         /** precedence on focus */
@@ -73,9 +84,9 @@ namespace Lightly
         /** precedence on focus */
         qreal frameOpacity( const QObject* object )
         {
-            if( isAnimated( object, AnimationEnable ) ) return data( object, AnimationEnable ).data()->opacity();
-            else if( isAnimated( object, AnimationFocus ) ) return data( object, AnimationFocus ).data()->opacity();
-            else if( isAnimated( object, AnimationHover ) ) return data( object, AnimationHover ).data()->opacity();
+            if( isAnimated( object, AnimationEnable ) ) return currentOpacity( object, AnimationEnable );
+            else if( isAnimated( object, AnimationFocus ) ) return currentOpacity( object, AnimationFocus );
+            else if( isAnimated( object, AnimationHover ) ) return currentOpacity( object, AnimationHover );
             else return AnimationData::OpacityInvalid;
         }
 
@@ -94,46 +105,30 @@ namespace Lightly
         /** precedence on mouseOver */
         qreal buttonOpacity( const QObject* object )
         {
-            if( isAnimated( object, AnimationEnable ) ) return data( object, AnimationEnable ).data()->opacity();
-            else if( isAnimated( object, AnimationPressed ) ) return data( object, AnimationPressed ).data()->opacity();
-            else if( isAnimated( object, AnimationHover ) ) return data( object, AnimationHover ).data()->opacity();
-            else if( isAnimated( object, AnimationFocus ) ) return data( object, AnimationFocus ).data()->opacity();
+            if( isAnimated( object, AnimationEnable ) ) return currentOpacity( object, AnimationEnable );
+            else if( isAnimated( object, AnimationPressed ) ) return currentOpacity( object, AnimationPressed );
+            else if( isAnimated( object, AnimationHover ) ) return currentOpacity( object, AnimationHover );
+            else if( isAnimated( object, AnimationFocus ) ) return currentOpacity( object, AnimationFocus );
             else return AnimationData::OpacityInvalid;
         }
 
         //* duration
-        void setEnabled( bool value ) override
-        {
-            BaseEngine::setEnabled( value );
-            _hoverData.setEnabled( value );
-            _focusData.setEnabled( value );
-            _enableData.setEnabled( value );
-            _pressedData.setEnabled( value );
-        }
+        void setEnabled( bool value ) override;
 
         //* duration
-        void setDuration( int value ) override
-        {
-            BaseEngine::setDuration( value );
-            _hoverData.setDuration( value );
-            _focusData.setDuration( value );
-            _enableData.setDuration( value );
-            _pressedData.setDuration( value/2 );
-        }
+        void setDuration( int value ) override;
+
+        //* advance running animations by elapsed milliseconds, and store widgets that need repaint
+        /** returns true if some animations are still running */
+        bool advance( int elapsed, QVector<QWidget*>& dirty );
+
+        //* event filter, used to trigger enability animations
+        bool eventFilter( QObject*, QEvent* ) override;
 
         public Q_SLOTS:
 
         //* remove widget from map
-        bool unregisterWidget( QObject* object ) override
-        {
-            if( !object ) return false;
-            bool found = false;
-            if( _hoverData.unregisterWidget( object ) ) found = true;
-            if( _focusData.unregisterWidget( object ) ) found = true;
-            if( _enableData.unregisterWidget( object ) ) found = true;
-            if( _pressedData.unregisterWidget( object ) ) found = true;
-            return found;
-        }
+        bool unregisterWidget( QObject* object ) override;
 
         protected:
 
@@ -145,7 +140,66 @@ namespace Lightly
 
         private:
 
-        //* maps
+        //* lightweight animation state
+        class AnimationSlot
+        {
+            public:
+
+            QWidget* target = nullptr;
+            int duration = 0;
+            int currentTime = 0;
+            qreal opacity = 0;
+            QEasingCurve::Type easing = QEasingCurve::InQuint;
+            bool forward = true;
+            bool running = false;
+            bool initialized = false;
+            bool state = false;
+        };
+
+        //* slot indices for a given widget, one per animation mode, -1 if not registered
+        class SlotIndices
+        {
+            public:
+
+            int hover = -1;
+            int focus = -1;
+            int enable = -1;
+            int pressed = -1;
+
+            int& at( AnimationMode mode );
+        };
+
+        //* returns slot associated to widget and mode, if any
+        AnimationSlot* slot( const QObject*, AnimationMode );
+
+        //* allocate new slot
+        int allocateSlot( QWidget*, int duration, bool state );
+
+        //* release slot
+        void releaseSlot( int );
+
+        //* opacity, for animated object
+        qreal currentOpacity( const QObject*, AnimationMode );
+
+        //* update slot opacity from its current time
+        static void updateOpacity( AnimationSlot& );
+
+        //* clock
+        WeakPointer<AnimationClock> _clock;
+
+        //* animation slots
+        QVector<AnimationSlot> _slots;
+
+        //* unused slots, to be recycled
+        QVector<int> _freeSlots;
+
+        //* running slots
+        QVector<int> _runningSlots;
+
+        //* slot indices, per widget
+        QHash<const QObject*, SlotIndices> _slotIndices;
+
+        //* maps, used by derived engines
         DataMap<WidgetStateData> _hoverData;
         DataMap<WidgetStateData> _focusData;
         DataMap<WidgetStateData> _enableData;
@@ -20,8 +20,10 @@
 #include "lightlywidgetexplorer.h"
 
 #include "lightly.h"
+#include "lightlypropertynames.h"
 
 #include <QTextStream>
+#include <QVariant>
 #include <QApplication>
 #include <QMouseEvent>
 #include <QPainter>
@@ -157,6 +159,11 @@ namespace Lightly
             << " minimumSizeHint: " << widget->minimumSizeHint().width() << "," << widget->minimumSizeHint().height()
             << " hover: " << widget->testAttribute( Qt::WA_Hover );
 
+        // translucent background area filled during last paint event
+        const QVariant backgroundFill( widget->property( PropertyNames::backgroundFill ) );
+        if( backgroundFill.isValid() )
+        { QTextStream( &out ) << " background fill: " << backgroundFill.toLongLong() << " pixels"; }
+
         return out;
     }
 
@@ -41,7 +41,8 @@ namespace Lightly
         explicit WidgetExplorer( QObject* );
 
         //* enable
-        bool enabled() const;
+        bool enabled() const
+        { return _enabled; }
 
         //* enable
         void setEnabled( bool );
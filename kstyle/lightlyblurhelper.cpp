@@ -39,9 +39,15 @@
 #include <QMenu>
 #include <QPair>
 #include <QRegularExpression>
+#include <QTimerEvent>
 #include <QToolBar>
 #include <QVector>
 //#include <QDebug>
+
+#if LIGHTLY_HAVE_X11
+#include <QX11Info>
+#include <xcb/xcb.h>
+#endif
 namespace
 {
 	
@@ -109,13 +115,13 @@ namespace Lightly
     //___________________________________________________________
     void BlurHelper::registerWidget(QWidget* widget, const bool isDolphin)
     {
+        _isDolphin = isDolphin;
+
         // install event filter
         addEventFilter(widget);
 
         // schedule shadow area repaint
-        update(widget);
-        
-        _isDolphin = isDolphin;
+        update(widget, true);
     }
 
     //___________________________________________________________
@@ -123,6 +129,11 @@ namespace Lightly
     {
         // remove event filter
         widget->removeEventFilter(this);
+
+        // clear cached data
+        _pendingWidgets.remove(widget);
+        if (_data.remove(widget))
+            disconnect(widget, &QObject::destroyed, this, &BlurHelper::widgetDestroyed);
     }
 
     //___________________________________________________________
@@ -130,8 +141,30 @@ namespace Lightly
     {
 
         switch (event->type()) {
-            case QEvent::Hide:
             case QEvent::Show:
+            {
+                // cast to widget and check
+                QWidget* widget(qobject_cast<QWidget*>(object));
+
+                if (!widget)
+                    break;
+
+                // the native window may have been recreated, always send the region
+                update(widget, true);
+                break;
+            }
+
+            case QEvent::Hide:
+            {
+                // region will be sent again on next show
+                auto iter(_data.find(object));
+                if (iter != _data.end()) {
+                    iter->hasRegion = false;
+                    iter->hasOpaqueRegion = false;
+                }
+                break;
+            }
+
             case QEvent::Resize:
             {
                 // cast to widget and check
@@ -140,7 +173,22 @@ namespace Lightly
                 if (!widget)
                     break;
 
-                update(widget);
+                delayedUpdate(widget);
+                break;
+            }
+
+            case QEvent::ChildAdded:
+            case QEvent::ChildPolished:
+            case QEvent::ChildRemoved:
+            {
+                // children lists must be rebuilt
+                auto iter(_data.find(object));
+                if (iter == _data.end())
+                    break;
+
+                iter->childrenValid = false;
+                if (event->type() == QEvent::ChildRemoved)
+                    iter->fragments.remove(static_cast<QChildEvent*>(event)->child());
                 break;
             }
 
@@ -150,7 +198,79 @@ namespace Lightly
         // never eat events
         return false;
     }
-    
+
+    //___________________________________________________________
+    void BlurHelper::timerEvent(QTimerEvent* event)
+    {
+        if (event->timerId() == _timer.timerId()) {
+
+            _timer.stop();
+            for (const WidgetPointer& widget : qAsConst(_pendingWidgets)) {
+                if (widget)
+                    update(widget.data());
+            }
+
+            _pendingWidgets.clear();
+
+        } else {
+
+            QObject::timerEvent(event);
+
+        }
+    }
+
+    //___________________________________________________________
+    void BlurHelper::widgetDestroyed(QObject* object)
+    {
+        _data.remove(object);
+        _pendingWidgets.remove(static_cast<QWidget*>(object));
+    }
+
+    //___________________________________________________________
+    void BlurHelper::delayedUpdate(QWidget* widget)
+    {
+        _pendingWidgets.insert(widget, widget);
+
+        // one update per frame at most
+        if (!_timer.isActive())
+            _timer.start(16, this);
+    }
+
+    //___________________________________________________________
+    QRegion BlurHelper::fragment(WindowData& data, const QObject* object, const QRect& rect, int corners, int radius) const
+    {
+        Fragment& fragment(data.fragments[object]);
+        if (fragment.rect != rect || fragment.corners != corners || fragment.radius != radius || fragment.region.isNull()) {
+            fragment.rect = rect;
+            fragment.corners = corners;
+            fragment.radius = radius;
+            fragment.region = roundedRegion(rect, radius, corners & TopLeft, corners & TopRight, corners & BottomLeft, corners & BottomRight);
+        }
+
+        return fragment.region;
+    }
+
+    //___________________________________________________________
+    void BlurHelper::updateChildren(QWidget* widget, WindowData& data) const
+    {
+        data.toolBars.clear();
+        data.sideBars.clear();
+        data.pageWidgets.clear();
+
+        static const QRegularExpression sideBarExpression(QStringLiteral("^(places|terminal|info|folders)Dock$"));
+        const QList<QWidget *> children = widget->findChildren<QWidget *>(QString(), Qt::FindDirectChildrenOnly);
+        for (auto child : children) {
+            if (qobject_cast<QToolBar*>(child))
+                data.toolBars.append(child);
+            else if (sideBarExpression.match(child->objectName()).hasMatch())
+                data.sideBars.append(child);
+            else if (child->inherits("KPageWidget"))
+                data.pageWidgets.append(child);
+        }
+
+        data.childrenValid = true;
+    }
+
     //___________________________________________________________
     QRegion BlurHelper::blurRegion (QWidget* widget) const
     {
@@ -164,20 +284,26 @@ namespace Lightly
         if (!wMask.isEmpty() && wMask != QRegion(rect))
             return QRegion();
 
-        else if ((qobject_cast<QMenu*>(widget)
+        WindowData& data(_data[widget]);
+        const int radius(StyleConfigData::cornerRadius());
+
+        if ((qobject_cast<QMenu*>(widget)
             && !widget->testAttribute(Qt::WA_X11NetWmWindowTypeMenu)) // not a detached menu
             || widget->inherits("QComboBoxPrivateContainer"))
         {
-            return roundedRegion(rect, StyleConfigData::cornerRadius()+1, true, true, true, true);
+            return fragment(data, widget, rect, TopLeft|TopRight|BottomLeft|BottomRight, radius+1);
         } 
         else 
             {
                 // blur entire window
                 if( widget->palette().color( QPalette::Window ).alpha() < 255 )
-                    return roundedRegion(rect, StyleConfigData::cornerRadius(), false, false, true, true);
+                    return fragment(data, widget, rect, BottomLeft|BottomRight, radius);
                 
                 // blur specific widgets
                 QRegion region;
+
+                // cached children lists
+                if( !data.childrenValid ) updateChildren( widget, data );
                 
                 // toolbar and menubar
                 if( _translucentTitlebar )
@@ -196,15 +322,18 @@ namespace Lightly
                         }
                     }
                 
-                    QList<QToolBar *> toolbars = widget->window()->findChildren<QToolBar *>( QString(), Qt::FindDirectChildrenOnly );
+                    const QList<QPointer<QWidget>>& toolbars = data.toolBars;
                     QRect mainToolbar = QRect();
+                    const QWidget* mainToolbarWidget = nullptr;
                     
                     // just assuming
                     Qt::Orientation orientation = Qt::Vertical;
                     
                     // find which one is the main toolbar
-                    for( auto tb : toolbars )
+                    for( const auto& tbPointer : toolbars )
                     {
+                        QToolBar* tb = static_cast<QToolBar*>( tbPointer.data() );
+
                         // single toolbar
                         if ( tb && tb->isVisible() && toolbars.length() == 1 ) {
                             region += QRegion( QRect( tb->pos(), tb->rect().size() ) );
@@ -215,6 +344,7 @@ namespace Lightly
                         {
                             if( mainToolbar.isNull() ) {
                                 mainToolbar = QRect( tb->pos(), tb->rect().size() );
+                                mainToolbarWidget = tb;
                                 orientation = tb->orientation();
                             }
                             
@@ -223,6 +353,7 @@ namespace Lightly
                             {
                                 if( (tb->y() < mainToolbar.y()) || (tb->y() == mainToolbar.y() && tb->x() < mainToolbar.x()) ) {
                                     mainToolbar = QRect( tb->pos(), tb->rect().size() );
+                                    mainToolbarWidget = tb;
                                     orientation = tb->orientation();
                                 }
                             }
@@ -246,7 +377,7 @@ namespace Lightly
                             
                             // round corners if it is at the bottom
                             else if ( mainToolbar.y() + mainToolbar.height() == widget->height() )
-                                region += roundedRegion( mainToolbar, StyleConfigData::cornerRadius(),  false, false, false, true );
+                                region += fragment( data, mainToolbarWidget, mainToolbar, BottomRight, radius );
                             
                             //else
                             //    region += mainToolbar;
@@ -255,11 +386,11 @@ namespace Lightly
                             
                             // round bottom left
                             if( mainToolbar.x() == 0 ) 
-                                region += roundedRegion( mainToolbar, StyleConfigData::cornerRadius(),  false, false, true, false );
+                                region += fragment( data, mainToolbarWidget, mainToolbar, BottomLeft, radius );
                             
                             // round bottom right
                             else if( mainToolbar.x() + mainToolbar.width() == widget->width() ) 
-                                region += roundedRegion( mainToolbar, StyleConfigData::cornerRadius(),  false, false, false, true );
+                                region += fragment( data, mainToolbarWidget, mainToolbar, BottomRight, radius );
                             
                             // no round corners
                             //else region += mainToolbar; //FIXME: is this valid?
@@ -275,69 +406,57 @@ namespace Lightly
                     {
                         
                         // sidetoolbar 
-                        if( !_translucentTitlebar )
+                        if( !_translucentTitlebar && !data.toolBars.isEmpty() )
                         {
-                            QToolBar *toolbar = widget->window()->findChild<QToolBar *>( QString(), Qt::FindDirectChildrenOnly );
+                            QToolBar *toolbar = static_cast<QToolBar*>( data.toolBars.first().data() );
                             if( toolbar ) {
                                 if( toolbar->orientation() == Qt::Vertical) {
-                                   if( toolbar->x() == 0 ) region += roundedRegion( QRect( toolbar->pos(), toolbar->rect().size() ), StyleConfigData::cornerRadius(),  false, false, true, false );
-                                   else region += roundedRegion( QRect( toolbar->pos(), toolbar->rect().size() ), StyleConfigData::cornerRadius(),  false, false, false, true );
+                                   const QRect toolbarRect( toolbar->pos(), toolbar->rect().size() );
+                                   if( toolbar->x() == 0 ) region += fragment( data, toolbar, toolbarRect, BottomLeft, radius );
+                                   else region += fragment( data, toolbar, toolbarRect, BottomRight, radius );
                                 }
                             }
                         }
                         
                         // sidepanels
-                        QList<QWidget *> sidebars = widget->findChildren<QWidget *>( QRegularExpression("^(places|terminal|info|folders)Dock$"), Qt::FindDirectChildrenOnly );
-                        for ( auto sb : sidebars )
+                        for ( const auto& sb : qAsConst( data.sideBars ) )
                         {
                             if ( sb && sb->isVisible() )
                             {
+                                const QRect sbRect( sb->pos(), sb->rect().size() );
                                 if( sb->x() == 0 ) 
-                                    region += roundedRegion( QRect( sb->pos(), sb->rect().size() ), StyleConfigData::cornerRadius(), false, false, true, false);
+                                    region += fragment( data, sb, sbRect, BottomLeft, radius );
                                 else if ( sb->x() + sb->width() == widget->width() ) 
-                                    region += roundedRegion( QRect( sb->pos(), sb->rect().size() ), StyleConfigData::cornerRadius(), false, false, false, true);
-                                else region += QRect( sb->pos(), sb->rect().size() );
+                                    region += fragment( data, sb, sbRect, BottomRight, radius );
+                                else region += sbRect;
                             }
                         }
                         
                         // settings page
                         if( (widget->windowFlags() & Qt::WindowType_Mask) == Qt::Dialog )
                         {
-                            QList<QWidget *> dialogWidgets = widget->findChildren<QWidget *>( QString(), Qt::FindDirectChildrenOnly );
-                            for( auto w : dialogWidgets ) 
+                            // the side panel property is set when the view gets polished, so keep looking until found
+                            if( !data.sidePanel )
                             {
-                                if( w->inherits( "KPageWidget" ) )
+                                for( const auto& w : qAsConst( data.pageWidgets ) )
                                 {
+                                    if( !w ) continue;
                                     QList<QWidget *> KPageWidgets = w->findChildren<QWidget *>( QString(), Qt::FindDirectChildrenOnly );
                                     for ( auto wid : KPageWidgets ){
                                         if( wid->property( PropertyNames::sidePanelView ).toBool() ) {
-                                            region += roundedRegion( QRect( wid->pos(), wid->rect().size() ), StyleConfigData::cornerRadius(),  false, false, true, false );
+                                            data.sidePanel = wid;
                                             break;
                                         }
                                     }
+                                    if( data.sidePanel ) break;
                                 }
                             }
+
+                            if( QWidget* wid = data.sidePanel.data() )
+                            { region += fragment( data, wid, QRect( wid->pos(), wid->rect().size() ), BottomLeft, radius ); }
                         }
                         
                     }
-
-                    /*if( (widget->windowFlags() & Qt::WindowType_Mask) == Qt::Dialog )
-                    {
-                        QList<QWidget *> dialogWidgets = widget->findChildren<QWidget *>( QString(), Qt::FindDirectChildrenOnly );
-                        for( auto w : dialogWidgets ) 
-                        {
-                            if( w->inherits( "KPageWidget" ) )
-                            {
-                                QList<QWidget *> KPageWidgets = w->findChildren<QWidget *>( QString(), Qt::FindDirectChildrenOnly );
-                                for ( auto wid : KPageWidgets ){
-                                    if( wid->property( PropertyNames::sidePanelView ).toBool() ) {
-                                        region += roundedRegion( QRect( wid->pos(), wid->rect().size() ), StyleConfigData::cornerRadius(),  false, false, true, false );
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-                    }*/
                     
                 }
                     
@@ -346,7 +465,7 @@ namespace Lightly
         }   
 
     //___________________________________________________________
-    void BlurHelper::update(QWidget* widget) const
+    void BlurHelper::update(QWidget* widget, bool force)
     {
         /*
         directly from bespin code. Supposedly prevent playing with some 'pseudo-widgets'
@@ -355,9 +474,25 @@ namespace Lightly
         if (!(widget->testAttribute(Qt::WA_WState_Created) || widget->internalWinId()))
             return;
 
+        // make sure cached data is removed together with the widget
+        if (!_data.contains(widget))
+            connect(widget, &QObject::destroyed, this, &BlurHelper::widgetDestroyed, Qt::UniqueConnection);
+
         QRegion region = blurRegion(widget);
+
+        // opaque region also depends on the window size, so it is checked even when the blur region is unchanged
+        WindowData& data(_data[widget]);
+        updateOpaqueRegion(widget, data, region, force);
+
         if (region.isNull()) return;
 
+        // nothing to do if the region did not change
+        if (!force && data.hasRegion && data.region == region)
+            return;
+
+        data.region = region;
+        data.hasRegion = true;
+
         KWindowEffects::enableBlurBehind(widget->isWindow() ? widget->winId() : widget->window()->winId(), true, region);
         //KWindowEffects::enableBackgroundContrast (widget->isWindow() ? widget->winId() : widget->window()->winId(), true, 1.0, 1.2, 1.3, region );
 
@@ -366,4 +501,99 @@ namespace Lightly
             widget->update();
         }
     }
+
+    //___________________________________________________________
+    void BlurHelper::updateOpaqueRegion(QWidget* widget, WindowData& data, const QRegion& blurRegion, bool force)
+    {
+        #if LIGHTLY_HAVE_X11
+        if (!Helper::isX11() || !widget->isWindow() || !widget->isVisible())
+            return;
+
+        // only windows painted with an opaque background, outside of the blurred areas, have an opaque part.
+        // Menus and combobox popups have rounded corners all around, and masked windows are left alone
+        QRegion opaqueRegion;
+        if (_opaqueRegionEnabled
+            && widget->palette().color(QPalette::Window).alpha() == 255
+            && !qobject_cast<QMenu*>(widget)
+            && !widget->inherits("QComboBoxPrivateContainer")
+            && widget->mask().isEmpty())
+        {
+            const QRect rect(widget->rect());
+            const int radius(StyleConfigData::cornerRadius());
+            opaqueRegion = QRegion(rect) - blurRegion;
+
+            /*
+            the style paints toolbars, menubar and dolphin side panels translucent,
+            whether or not they are part of the blur region
+            */
+            if (!data.childrenValid)
+                updateChildren(widget, data);
+
+            const auto geometry = [](const QWidget* child) { return QRect(child->pos(), child->size()); };
+            if (QMainWindow* mw = qobject_cast<QMainWindow*>(widget)) {
+                if (QWidget* mb = mw->menuWidget())
+                    opaqueRegion -= geometry(mb);
+            }
+
+            for (const auto& child : qAsConst(data.toolBars)) {
+                if (child) opaqueRegion -= geometry(child);
+            }
+
+            for (const auto& child : qAsConst(data.sideBars)) {
+                if (child) opaqueRegion -= geometry(child);
+            }
+
+            if (QWidget* sidePanel = data.sidePanel.data())
+                opaqueRegion -= QRect(sidePanel->mapTo(widget, QPoint()), sidePanel->size());
+
+            // bottom corners are rounded together with the window decoration
+            opaqueRegion -= QRegion(rect.left(), rect.bottom() - radius + 1, radius, radius);
+            opaqueRegion -= QRegion(rect.right() - radius + 1, rect.bottom() - radius + 1, radius, radius);
+        }
+
+        // nothing to do if the region did not change
+        if (!force && data.hasOpaqueRegion && data.opaqueRegion == opaqueRegion)
+            return;
+
+        data.opaqueRegion = opaqueRegion;
+        data.hasOpaqueRegion = true;
+
+        xcb_connection_t* connection(QX11Info::connection());
+        static xcb_atom_t atom(XCB_ATOM_NONE);
+        if (atom == XCB_ATOM_NONE) {
+            const QByteArray name(QByteArrayLiteral("_NET_WM_OPAQUE_REGION"));
+            const xcb_intern_atom_cookie_t cookie(xcb_intern_atom(connection, false, name.size(), name.constData()));
+            QScopedPointer<xcb_intern_atom_reply_t, QScopedPointerPodDeleter> reply(xcb_intern_atom_reply(connection, cookie, nullptr));
+            if (reply)
+                atom = reply->atom;
+
+            if (atom == XCB_ATOM_NONE)
+                return;
+        }
+
+        const xcb_window_t window(widget->winId());
+        if (opaqueRegion.isEmpty()) {
+            xcb_delete_property(connection, window, atom);
+            return;
+        }
+
+        // property is expressed in native pixels
+        const qreal dpr(widget->devicePixelRatioF());
+        QVector<quint32> values;
+        values.reserve(4*opaqueRegion.rectCount());
+        for (const QRect& rect : opaqueRegion) {
+            values.append(qRound(rect.x()*dpr));
+            values.append(qRound(rect.y()*dpr));
+            values.append(qRound(rect.width()*dpr));
+            values.append(qRound(rect.height()*dpr));
+        }
+
+        xcb_change_property(connection, XCB_PROP_MODE_REPLACE, window, atom, XCB_ATOM_CARDINAL, 32, values.size(), values.constData());
+        #else
+        Q_UNUSED(widget)
+        Q_UNUSED(data)
+        Q_UNUSED(blurRegion)
+        Q_UNUSED(force)
+        #endif
+    }
 }
@@ -34,7 +34,10 @@
 #include "lightly.h"
 #include "lightlyhelper.h"
 
+#include <QBasicTimer>
 #include <QHash>
+#include <QPointer>
+#include <QRegion>
 #include <QSet>
 #include <QObject>
 
@@ -60,13 +63,21 @@ namespace Lightly
         
         //! force update
         void forceUpdate( QWidget* widget )
-        { if( widget->isWindow() ) update( widget ); }
+        { if( widget->isWindow() ) delayedUpdate( widget ); }
         
         void setTranslucentTitlebar( bool value )
         { _translucentTitlebar = value; }
 
+        //! opaque region hint
+        /*! must be disabled when the style paints translucent widgets that are not tracked here */
+        void setOpaqueRegionEnabled( bool value )
+        { _opaqueRegionEnabled = value; }
+
         protected:
 
+        //! timer event, used to coalesce resize events
+        void timerEvent( QTimerEvent* ) override;
+
         //! install event filter to object, in a unique way
         void addEventFilter( QObject* object )
         {
@@ -78,13 +89,93 @@ namespace Lightly
         QRegion blurRegion (QWidget* widget) const;
 
         //! update blur regions for given widget
-        void update( QWidget* ) const;
-        
+        /*! blur is only sent to the compositor, and the widget repainted, if the region changed, unless force is true */
+        void update( QWidget*, bool force = false );
+
+        //! schedule update of blur regions for given widget, at most once per frame
+        void delayedUpdate( QWidget* );
+
+        protected Q_SLOTS:
+
+        //! remove cached data for destroyed widget
+        void widgetDestroyed( QObject* );
+
         private:
+
+        //! region fragment, computed from one child widget geometry
+        class Fragment
+        {
+            public:
+
+            QRect rect;
+            int corners = 0;
+            int radius = 0;
+            QRegion region;
+        };
+
+        //! per window cached data
+        class WindowData
+        {
+            public:
+
+            //! true if the children lists below are up to date
+            bool childrenValid = false;
+
+            //! direct toolbar children of the window
+            QList<QPointer<QWidget>> toolBars;
+
+            //! dolphin dock widgets
+            QList<QPointer<QWidget>> sideBars;
+
+            //! KPageWidget children, in dialogs
+            QList<QPointer<QWidget>> pageWidgets;
+
+            //! side panel view of KPageWidget, in dialogs
+            QPointer<QWidget> sidePanel;
+
+            //! region fragments, keyed by the widget they are computed from
+            QHash<const QObject*, Fragment> fragments;
+
+            //! last region sent to the compositor
+            QRegion region;
+            bool hasRegion = false;
+
+            //! last opaque region hint sent to the compositor
+            QRegion opaqueRegion;
+            bool hasOpaqueRegion = false;
+        };
+
+        //! corners to be rounded
+        enum Corner
+        {
+            TopLeft = 1<<0,
+            TopRight = 1<<1,
+            BottomLeft = 1<<2,
+            BottomRight = 1<<3
+        };
+
+        //! rounded region for given rect and corners, reusing cached fragment when geometry did not change
+        QRegion fragment( WindowData&, const QObject*, const QRect&, int corners, int radius ) const;
+
+        //! update children lists for given window
+        void updateChildren( QWidget*, WindowData& ) const;
+
+        //! publish the part of the window that is painted opaque, so that the compositor needs not blend it
+        void updateOpaqueRegion( QWidget*, WindowData&, const QRegion& blurRegion, bool force );
         
         bool _isDolphin = false;
         bool _translucentTitlebar = false;
-            
+        bool _opaqueRegionEnabled = true;
+
+        //! cached data, per registered window
+        mutable QHash<const QObject*, WindowData> _data;
+
+        //! widgets for which blur region update is pending
+        using WidgetPointer = QPointer<QWidget>;
+        QHash<QWidget*, WidgetPointer> _pendingWidgets;
+
+        //! delayed update timer
+        QBasicTimer _timer;
 
     };
 
@@ -43,6 +43,22 @@ namespace Lightly
     //* contrast for arrow and treeline rendering
     static const qreal arrowShade = 0.15;
 
+    //* room around the line edit frame for the focus ring shadows, largest one being 6 pixels, offset by 1
+    static const int focusRingMargin = 8;
+
+    //* memory used by a tileset, in bytes
+    static int tileSetCost( const TileSet& tileSet )
+    {
+        int cost( 0 );
+        for( int index = 0; index < 9; ++index )
+        {
+            const QPixmap pixmap( tileSet.pixmap( index ) );
+            cost += pixmap.width()*pixmap.height()*pixmap.depth()/8;
+        }
+
+        return cost;
+    }
+
     //____________________________________________________________________
     Helper::Helper( KSharedConfig::Ptr config, QObject *parent ):
         _config( std::move( config ) )
@@ -85,7 +101,21 @@ namespace Lightly
         _activeTitleBarTextColor = appGroup.readEntry( "activeForeground", globalGroup.readEntry( "activeForeground", palette.color( QPalette::Active, QPalette::HighlightedText ) ) );
         _inactiveTitleBarColor = appGroup.readEntry( "inactiveBackground", globalGroup.readEntry( "inactiveBackground", palette.color( QPalette::Disabled, QPalette::Highlight ) ) );
         _inactiveTitleBarTextColor = appGroup.readEntry( "inactiveForeground", globalGroup.readEntry( "inactiveForeground", palette.color( QPalette::Disabled, QPalette::HighlightedText ) ) );
-        
+
+        // shadow cache, budget is stored in KiB
+        _shadowCache.clear();
+        _shadowCache.setMaxCost( qMax( 0, StyleConfigData::shadowCacheSize() )*1024 );
+
+        // top highlight tilesets
+        _highlightCache.clear();
+
+        // focus ring tilesets depend on shadow settings
+        _focusRingCache.clear();
+
+        // ellipse shadows and busy progress bar stripes depend on palette
+        _ellipseShadowCache.clear();
+        _busyStripeCache.clear();
+
     }
 
     //____________________________________________________________________
@@ -615,12 +645,33 @@ namespace Lightly
         Q_UNUSED(active)
         //if (!active) {renderOutline(painter, rect, cornerRadius, 30);return;}
         CustomShadowParams params = CustomShadowParams( QPoint(xOffset, yOffset), size, color );
-        TileSet shadow = ShadowHelper::shadowTiles( cornerRadius, params );
+        const TileSet shadow( shadowTiles( cornerRadius, params ) );
         shadow.render( rect.adjusted(-params.radius, -params.radius, params.radius + params.offset.x(), params.radius + params.offset.y() ) , painter, tiles);
         //qDebug() << "shadow on: " << rect.adjusted(-params.radius, -params.radius, params.radius, params.radius);
         
     }
     
+    //______________________________________________________________________________
+    TileSet Helper::shadowTiles( const int cornerRadius, const CustomShadowParams& params ) const
+    {
+
+        const ShadowCacheKey key( params, cornerRadius, qApp->devicePixelRatio() );
+        if( const TileSet* cached = _shadowCache.object( key ) )
+        { return *cached; }
+
+        const BoxShadowRenderer::Algorithm algorithm( StyleConfigData::analyticWidgetShadows() ? BoxShadowRenderer::Analytic : BoxShadowRenderer::BoxBlur );
+        const TileSet tileSet( ShadowHelper::shadowTiles( cornerRadius, params, CustomShadowParams(), algorithm ) );
+        if( !tileSet.isValid() ) return tileSet;
+
+        // tilesets that exceed the budget on their own are not cached
+        const int cost( tileSetCost( tileSet ) );
+        if( cost <= _shadowCache.maxCost() )
+        { _shadowCache.insert( key, new TileSet( tileSet ), cost ); }
+
+        return tileSet;
+
+    }
+
     //______________________________________________________________________________
     void Helper::renderEllipseShadow(
         QPainter* painter, const QRectF& rect, QColor color,
@@ -637,47 +688,93 @@ namespace Lightly
         if ( size < 1 ) return;
         if (color.alphaF() < 0.01) return;
         
-        // temporaty values
-        int tx = rect.left() - size + xOffset;
-        int ty = rect.top() - size + yOffset;
-        int tw = rect.width() + size * 2;
-        int th = rect.height() + size * 2;
+        // outermost layer, and number of concentric layers
+        const QRect shadowRect( rect.left() - size + xOffset, rect.top() - size + yOffset, rect.width() + size * 2, rect.height() + size * 2 );
+        const int layers( qFloor( rect.left() + qMax(xOffset, yOffset) - shadowRect.left() ) + 1 );
+        if( layers < 1 ) return;
+        
+        painter->drawPixmap( shadowRect.topLeft(), ellipseShadowPixmap( shadowRect.size(), layers, color, param1, param2 ) );
+    }
+    
+    //______________________________________________________________________________
+    QPixmap Helper::ellipseShadowPixmap( const QSize& size, int layers, const QColor& color, const float param1, const float param2 ) const
+    {
+        
+        const qreal dpr( qApp->devicePixelRatio() );
+        const EllipseShadowCacheKey key( size, layers, color, param1, param2, dpr );
+        if( const QPixmap* cached = _ellipseShadowCache.object( key ) )
+        { return *cached; }
+        
+        QPixmap* pixmap( new QPixmap( size*dpr ) );
+        pixmap->setDevicePixelRatio( dpr );
+        pixmap->fill( Qt::transparent );
+        
+        QPainter p( pixmap );
+        p.setRenderHint( QPainter::Antialiasing );
+        p.setPen( Qt::NoPen );
+        
+        // each layer is one pixel smaller on every side, with alpha growing towards the center
+        QColor layerColor( color );
+        QRect layerRect( QPoint( 0, 0 ), size );
         float alpha = color.alphaF();
         
-        while (tx <= rect.left() + qMax(xOffset, yOffset)) {
+        for( int i = 0; i < layers; ++i ) {
             
-            color.setAlpha( alpha );
-            painter->setBrush( color );
+            layerColor.setAlpha( alpha );
+            p.setBrush( layerColor );
             
-            painter->drawEllipse( QRect(tx, ty, tw, th) );
+            p.drawEllipse( layerRect );
             
-            tx++;
-            ty++;
-            tw -= 2;
-            th -= 2;
+            layerRect.adjust( 1, 1, -1, -1 );
             alpha += param1 + alpha/param2;
         }
+        
+        p.end();
+        
+        _ellipseShadowCache.insert( key, pixmap );
+        return *pixmap;
+        
     }
     
     //______________________________________________________________________________
     void Helper::topHighlight( QPainter* painter, const QRectF& rect, const int radius, const QColor& color ) const
     {
-        QPixmap pixmap = QPixmap(rect.width(), rect.height());
+        const TileSet tileSet( highlightTiles( qMax( radius, 0 ), color ) );
+        tileSet.render( QRect( rect.x(), rect.y(), rect.width(), rect.height() ), painter, TileSet::Ring );
+    }
+
+    //______________________________________________________________________________
+    TileSet Helper::highlightTiles( const int radius, const QColor& color ) const
+    {
+
+        const qreal dpr( qApp->devicePixelRatio() );
+        const quint64 key( quint64( color.rgba() ) | ( quint64( radius & 0xff ) << 32 ) | ( quint64( qRound( dpr*100 ) & 0xffff ) << 40 ) );
+        if( const TileSet* cached = _highlightCache.object( key ) )
+        { return *cached; }
+
+        // the highlight is the difference between the rounded frame and the same frame moved down by one pixel,
+        // so that a source large enough for both corners plus a one pixel stretchable center is enough
+        const int size( 2*radius + 3 );
+        QPixmap pixmap( QSize( size, size )*dpr );
+        pixmap.setDevicePixelRatio( dpr );
         pixmap.fill( Qt::transparent );
+
         QPainter p( &pixmap );
-        
         p.setRenderHint( QPainter::Antialiasing );
-        
+
         p.setPen( Qt::NoPen );
         p.setBrush( color );
-        p.drawRoundedRect( QRect( 0, 0, rect.width(), rect.height() ), radius, radius );
-        
+        p.drawRoundedRect( QRect( 0, 0, size, size ), radius, radius );
+
         p.setCompositionMode(QPainter::CompositionMode_DestinationOut);
         p.setBrush( Qt::black );
-        p.drawRoundedRect( QRect( 0, 1, rect.width(), rect.height() ), radius, radius );
-        
-        painter->drawPixmap( QRect( rect.x(), rect.y(), rect.width(), rect.height() ), pixmap );
-        
+        p.drawRoundedRect( QRect( 0, 1, size, size ), radius, radius );
+        p.end();
+
+        TileSet* tileSet( new TileSet( pixmap, radius + 1, radius + 1, 1, 1 ) );
+        _highlightCache.insert( key, tileSet );
+        return *tileSet;
+
     }
 
     //______________________________________________________________________________
@@ -935,41 +1032,7 @@ namespace Lightly
                     //renderBoxShadow( painter, frameRect, 0, 1, 6, alphaColor(outline.darker(120), opacity) , radius, windowActive ); 
                     //renderBoxShadow( painter, frameRect, 0, 1, 4, alphaColor(outline.darker(120), opacity) , radius, windowActive );
 
-                    const qreal finalRadius ((frameRect.width()+Metrics::Frame_FrameWidth)*opacity);
-                    
-                    QPixmap mask = QPixmap(rect.width(), rect.height());	
-                    mask.fill( Qt::transparent );
-
-                    QPainter pmask( &mask );	
-                    pmask.setRenderHint( QPainter::Antialiasing );
-                    pmask.fillRect(rect, Qt::black);
-                    pmask.setPen( Qt::NoPen );
-                    pmask.setBrush( Qt::black );
-                    pmask.setCompositionMode(QPainter::CompositionMode_SourceOut);
-                    pmask.drawEllipse(QPointF(frameRect.x(), frameRect.y() + frameRect.height()/2), finalRadius, finalRadius);
-                    pmask.end();
-                    
-                    QPixmap pixmap = QPixmap(rect.width(), rect.height());	
-                    pixmap.fill( Qt::transparent );
-                    QPainter p( &pixmap );	
-                    p.setOpacity(0.3 + 0.7*opacity);
-                    p.setRenderHint( QPainter::Antialiasing );
-                    p.setCompositionMode(QPainter::CompositionMode_SourceOver);
-                    p.setPen(Qt::NoPen);
-                    renderBoxShadow( &p, frameRect, 0, 1, 6, outline.darker(120) , radius, windowActive ); // comment this out for only the outline animation
-                    renderBoxShadow( &p, frameRect, 0, 1, 4, outline.darker(130) , radius, windowActive ); // comment this out for only the outline animation
-                    renderBoxShadow( &p, frameRect, 0, 1, 4, outline.darker(140) , radius, windowActive ); // comment this out for only the outline animation
-                    p.setBrush( alphaColor( outline, 0.6 ) ) ;
-                    QRectF focusFrame = frameRect.adjusted( -2, -2, 2, 2 );
-                    p.drawRoundedRect( focusFrame, radius + 1, radius + 1); // outline around lineedit
-                    
-                    // mask
-                    //p.setOpacity(1);  // uncomment this for only outline animation
-                    p.setCompositionMode(QPainter::CompositionMode_DestinationOut);
-                    p.drawPixmap(rect, mask);
-                    p.end();
-                    
-                    painter->drawPixmap( rect, pixmap );
+                    renderFocusRingReveal( painter, frameRect, radius, outline, true, opacity );
                 }
                 
                 // focus animation done
@@ -989,40 +1052,7 @@ namespace Lightly
                 // focus out animation
                 if( mode == 2 && opacity > 0 && opacity < 1) {
                     
-                    const qreal finalRadius ((frameRect.width()+Metrics::Frame_FrameWidth)*opacity);
-                    
-                    QPixmap mask = QPixmap(rect.width(), rect.height());	
-                    mask.fill( Qt::transparent );
-
-                    QPainter pmask( &mask );
-                    pmask.setOpacity(1);
-                    pmask.setRenderHint( QPainter::Antialiasing );
-                    pmask.fillRect(rect, Qt::black);
-                    pmask.setPen( Qt::NoPen );
-                    pmask.setBrush( Qt::black );
-                    pmask.setCompositionMode(QPainter::CompositionMode_SourceOut);
-                    pmask.drawEllipse(QPointF(frameRect.x(), frameRect.y() + frameRect.height()/2), finalRadius, finalRadius);
-                    pmask.end();
-                    
-                    QPixmap pixmap = QPixmap(rect.width(), rect.height());	
-                    pixmap.fill( Qt::transparent );
-                    QPainter p( &pixmap );	
-                    //p.setOpacity(0.3 + 0.6*opacity);
-                    p.setRenderHint( QPainter::Antialiasing );
-                    p.setCompositionMode(QPainter::CompositionMode_SourceOver);
-                    p.setPen(Qt::NoPen);
-                    renderBoxShadow( &p, frameRect, 0, 1, 6, outline.darker(120) , radius, windowActive ); 
-                    renderBoxShadow( &p, frameRect, 0, 1, 4, outline.darker(120) , radius, windowActive );
-                    p.setBrush( alphaColor( outline, 0.6 ) ) ;
-                    QRectF focusFrame = frameRect.adjusted( -1, -1, 1, 1 );
-                    p.drawRoundedRect( focusFrame, radius + 1, radius + 1);
-                    
-                    // mask
-                    p.setCompositionMode(QPainter::CompositionMode_DestinationOut);
-                    p.drawPixmap(rect, mask);
-                    p.end();
-                    
-                    painter->drawPixmap( rect, pixmap );
+                    renderFocusRingReveal( painter, frameRect, radius, outline, false, opacity );
                     
                     // unfocused lineedit shadow effect
                     renderBoxShadow( painter, frameRect, 0, 1, 5, QColor(0,0,0,84*(1-opacity)), radius, windowActive );
@@ -1055,6 +1085,93 @@ namespace Lightly
         painter->drawRoundedRect( frameRect, radius, radius );
     }
     
+    //______________________________________________________________________________
+    void Helper::renderFocusRingReveal( QPainter* painter, const QRectF& frameRect, const qreal radius, const QColor& outline, const bool focusIn, const qreal opacity ) const
+    {
+
+        // the ring is revealed by a disc growing from the left edge of the frame
+        const qreal finalRadius ((frameRect.width()+Metrics::Frame_FrameWidth)*opacity);
+        const QPointF center( frameRect.x(), frameRect.y() + frameRect.height()/2 );
+
+        const QVector<TileSet> layers( focusRingTiles( radius, outline, focusIn ) );
+        const int margin( focusRingMargin );
+        const QRect ringRect( frameRect.toRect().adjusted( -margin, -margin, margin, margin ) );
+
+        painter->save();
+        QPainterPath clip;
+        clip.addEllipse( center, finalRadius, finalRadius );
+        painter->setClipPath( clip, Qt::IntersectClip );
+
+        // on focus in, layers fade in one by one, as when each was painted with the animation opacity
+        if( focusIn ) painter->setOpacity( painter->opacity()*( 0.3 + 0.7*opacity ) );
+        for( const TileSet& tileSet : layers )
+        { tileSet.render( ringRect, painter, TileSet::Full ); }
+
+        painter->restore();
+
+    }
+
+    //______________________________________________________________________________
+    QVector<TileSet> Helper::focusRingTiles( const qreal radius, const QColor& outline, const bool focusIn ) const
+    {
+
+        const qreal dpr( qApp->devicePixelRatio() );
+        const quint64 key( quint64( outline.rgba() ) | ( quint64( qRound( radius*16 ) & 0xfff ) << 32 ) | ( quint64( focusIn ) << 44 ) | ( quint64( qRound( dpr*100 ) & 0xffff ) << 45 ) );
+        if( const QVector<TileSet>* cached = _focusRingCache.object( key ) )
+        { return *cached; }
+
+        // corners must hold everything that is not uniform along the frame edges,
+        // while the frame itself is made large enough for the shadow tilesets to render unclipped
+        const int margin( focusRingMargin );
+        const int corner( margin + qCeil( radius ) + 3 );
+        const int frameSize( 4*corner );
+        const int size( frameSize + 2*margin );
+        const QRectF frameRect( margin, margin, frameSize, frameSize );
+
+        // each layer gets its own tileset, so that they can be faded separately
+        auto layers = new QVector<TileSet>;
+        const auto createPixmap = [&]()
+        {
+            QPixmap pixmap( QSize( size, size )*dpr );
+            pixmap.setDevicePixelRatio( dpr );
+            pixmap.fill( Qt::transparent );
+            return pixmap;
+        };
+
+        const auto addLayer = [&]( const QPixmap& pixmap )
+        { layers->append( TileSet( pixmap, corner, corner, size - 2*corner, size - 2*corner ) ); };
+
+        // shadow sizes and darkness factors
+        const QList<QPair<int, int>> shadows( focusIn ?
+            QList<QPair<int, int>>( { { 6, 120 }, { 4, 130 }, { 4, 140 } } ):
+            QList<QPair<int, int>>( { { 6, 120 }, { 4, 120 } } ) );
+
+        for( const auto& shadow : shadows )
+        {
+            QPixmap pixmap( createPixmap() );
+            QPainter p( &pixmap );
+            p.setRenderHint( QPainter::Antialiasing );
+            renderBoxShadow( &p, frameRect, 0, 1, shadow.first, outline.darker( shadow.second ), radius, true );
+            p.end();
+            addLayer( pixmap );
+        }
+
+        // outline around lineedit
+        const qreal outlineMargin( focusIn ? 2 : 1 );
+        QPixmap pixmap( createPixmap() );
+        QPainter p( &pixmap );
+        p.setRenderHint( QPainter::Antialiasing );
+        p.setPen( Qt::NoPen );
+        p.setBrush( alphaColor( outline, 0.6 ) );
+        p.drawRoundedRect( frameRect.adjusted( -outlineMargin, -outlineMargin, outlineMargin, outlineMargin ), radius + 1, radius + 1 );
+        p.end();
+        addLayer( pixmap );
+
+        _focusRingCache.insert( key, layers );
+        return *layers;
+
+    }
+
     //______________________________________________________________________________
     void Helper::renderGroupBox(
         QPainter* painter, const QRect& rect,
@@ -1550,41 +1667,42 @@ namespace Lightly
         const QRectF baseRect( rect );
         const qreal radius( 0.5*Metrics::ProgressBar_Thickness );
 
-        // setup brush
-        QPixmap pixmap( horizontal ? 2*Metrics::ProgressBar_BusyIndicatorSize : 1, horizontal ? 1:2*Metrics::ProgressBar_BusyIndicatorSize );
-        pixmap.fill( second );
-        if( horizontal )
-        {
+        // stripe phase along the pattern
+        const int period( 2*Metrics::ProgressBar_BusyIndicatorSize );
+        progress %= period;
+        if( !horizontal || reverse ) progress = period - progress - 1;
 
-            QPainter painter( &pixmap );
-            painter.setBrush( first );
-            painter.setPen( Qt::NoPen );
-
-            progress %= 2*Metrics::ProgressBar_BusyIndicatorSize;
-            if( reverse ) progress = 2*Metrics::ProgressBar_BusyIndicatorSize - progress - 1;
-            painter.drawRect( QRect( 0, 0, Metrics::ProgressBar_BusyIndicatorSize, 1 ).translated( progress, 0 ) );
+        // setup brush
+        QBrush brush( progressBarBusyStripe( first, second, horizontal ) );
+        brush.setTransform( horizontal ? QTransform::fromTranslate( progress, 0 ) : QTransform::fromTranslate( 0, progress ) );
 
-            if( progress > Metrics::ProgressBar_BusyIndicatorSize )
-            { painter.drawRect( QRect( 0, 0, Metrics::ProgressBar_BusyIndicatorSize, 1 ).translated( progress - 2*Metrics::ProgressBar_BusyIndicatorSize, 0 ) ); }
+        painter->setPen( Qt::NoPen );
+        painter->setBrush( brush );
+        painter->drawRoundedRect( baseRect, radius, radius );
 
-        } else {
+    }
 
-            QPainter painter( &pixmap );
-            painter.setBrush( first );
-            painter.setPen( Qt::NoPen );
+    //______________________________________________________________________________
+    QPixmap Helper::progressBarBusyStripe( const QColor& first, const QColor& second, bool horizontal ) const
+    {
 
-            progress %= 2*Metrics::ProgressBar_BusyIndicatorSize;
-            progress = 2*Metrics::ProgressBar_BusyIndicatorSize - progress - 1;
-            painter.drawRect( QRect( 0, 0, 1, Metrics::ProgressBar_BusyIndicatorSize ).translated( 0, progress ) );
+        const QPair<quint64, bool> key( ( quint64( first.rgba() ) << 32 ) | quint64( second.rgba() ), horizontal );
+        if( const QPixmap* cached = _busyStripeCache.object( key ) )
+        { return *cached; }
 
-            if( progress > Metrics::ProgressBar_BusyIndicatorSize )
-            { painter.drawRect( QRect( 0, 0, 1, Metrics::ProgressBar_BusyIndicatorSize ).translated( 0, progress - 2*Metrics::ProgressBar_BusyIndicatorSize ) ); }
+        // one full period, first color covering its leading half
+        const int period( 2*Metrics::ProgressBar_BusyIndicatorSize );
+        QPixmap* pixmap( new QPixmap( horizontal ? period : 1, horizontal ? 1 : period ) );
+        pixmap->fill( second );
 
-        }
+        QPainter painter( pixmap );
+        painter.setBrush( first );
+        painter.setPen( Qt::NoPen );
+        painter.drawRect( horizontal ? QRect( 0, 0, Metrics::ProgressBar_BusyIndicatorSize, 1 ) : QRect( 0, 0, 1, Metrics::ProgressBar_BusyIndicatorSize ) );
+        painter.end();
 
-        painter->setPen( Qt::NoPen );
-        painter->setBrush( pixmap );
-        painter->drawRoundedRect( baseRect, radius, radius );
+        _busyStripeCache.insert( key, pixmap );
+        return *pixmap;
 
     }
 
@@ -31,6 +31,7 @@
 #include <KColorScheme>
 #include <KSharedConfig>
 
+#include <QCache>
 #include <QPainterPath>
 #include <QIcon>
 #include <QWidget>
@@ -38,6 +39,92 @@
 namespace Lightly
 {
 
+    //* key used to cache widget shadow tilesets
+    struct ShadowCacheKey
+    {
+
+        ShadowCacheKey( const CustomShadowParams& params, int cornerRadius, qreal devicePixelRatio ):
+            offset( params.offset ),
+            size( params.radius ),
+            color( params.color.rgba() ),
+            cornerRadius( cornerRadius ),
+            devicePixelRatio( devicePixelRatio )
+        {}
+
+        bool operator == ( const ShadowCacheKey& other ) const
+        {
+            return
+                offset == other.offset &&
+                size == other.size &&
+                color == other.color &&
+                cornerRadius == other.cornerRadius &&
+                qFuzzyCompare( devicePixelRatio, other.devicePixelRatio );
+        }
+
+        QPoint offset;
+        int size;
+        QRgb color;
+        int cornerRadius;
+        qreal devicePixelRatio;
+
+    };
+
+    //* hash
+    inline uint qHash( const ShadowCacheKey& key, uint seed = 0 )
+    {
+        return ::qHash( key.offset.x(), seed ) ^
+            ::qHash( key.offset.y() << 8, seed ) ^
+            ::qHash( key.size << 16, seed ) ^
+            ::qHash( key.color, seed ) ^
+            ::qHash( key.cornerRadius << 24, seed ) ^
+            ::qHash( qRound( key.devicePixelRatio*100 ), seed );
+    }
+
+    //* key used to cache ellipse shadow pixmaps
+    struct EllipseShadowCacheKey
+    {
+
+        EllipseShadowCacheKey( const QSize& size, int layers, const QColor& color, float param1, float param2, qreal devicePixelRatio ):
+            size( size ),
+            layers( layers ),
+            color( color.rgba() ),
+            param1( param1 ),
+            param2( param2 ),
+            devicePixelRatio( devicePixelRatio )
+        {}
+
+        bool operator == ( const EllipseShadowCacheKey& other ) const
+        {
+            return
+                size == other.size &&
+                layers == other.layers &&
+                color == other.color &&
+                param1 == other.param1 &&
+                param2 == other.param2 &&
+                qFuzzyCompare( devicePixelRatio, other.devicePixelRatio );
+        }
+
+        QSize size;
+        int layers;
+        QRgb color;
+        float param1;
+        float param2;
+        qreal devicePixelRatio;
+
+    };
+
+    //* hash
+    inline uint qHash( const EllipseShadowCacheKey& key, uint seed = 0 )
+    {
+        return ::qHash( key.size.width(), seed ) ^
+            ::qHash( key.size.height() << 12, seed ) ^
+            ::qHash( key.layers << 24, seed ) ^
+            ::qHash( key.color, seed ) ^
+            ::qHash( key.param1, seed ) ^
+            ::qHash( key.param2*1000, seed ) ^
+            ::qHash( qRound( key.devicePixelRatio*100 ), seed );
+    }
+
     //* lightly style helper class.
     /** contains utility functions used at multiple places in both lightly style and lightly window decoration */
     class Helper : public QObject
@@ -182,11 +269,20 @@ namespace Lightly
             renderBoxShadow( painter, copy, xOffset, yOffset, size, color, cornerRadius, active, tiles );
         }
         
+        //* cached shadow tileset for widgets
+        TileSet shadowTiles( const int cornerRadius, const CustomShadowParams& ) const;
+
         //* shadow for ellipses
         void renderEllipseShadow( QPainter*, const QRectF&, QColor color, const int size, const float param1, const float param2, const int xOffset, const int yOffset, const bool outline = false, const int outlineStrength = 0 ) const;
+
+        //* cached ellipse shadow pixmap, made of the given number of concentric layers
+        QPixmap ellipseShadowPixmap( const QSize&, int layers, const QColor& color, const float param1, const float param2 ) const;
         
         //* top outline highlight in dark themes
         void topHighlight( QPainter*, const QRectF&, const int radius, const QColor& color = QColor(255, 255, 255, 20) ) const;
+
+        //* cached nine-slice tileset used to render the top highlight
+        TileSet highlightTiles( const int radius, const QColor& ) const;
         
         //* button frame
         void renderButtonFrame( QPainter*, const QRect&, const QColor& color, const QPalette& palette, const bool focus, const bool sunken, const bool mouseOver, const bool enabled, const bool windowActive, const AnimationMode mode = AnimationNone, const qreal opacity = AnimationData::OpacityInvalid ) const;
@@ -208,6 +304,12 @@ namespace Lightly
         
         //* line edit
         void renderLineEdit( QPainter*, const QRect&, const QColor& background, const QColor& outline, const bool hasFocus, const bool mouseOver, const bool enabled, const bool windowActive, const AnimationMode mode, const qreal opacity ) const;
+
+        //* line edit focus ring, revealed up to given animation progress
+        void renderFocusRingReveal( QPainter*, const QRectF& frameRect, const qreal radius, const QColor& outline, const bool focusIn, const qreal opacity ) const;
+
+        //* cached nine-slice tilesets for the line edit focus ring, one per shadow and outline layer, as rendered during focus in or focus out animations
+        QVector<TileSet> focusRingTiles( const qreal radius, const QColor& outline, const bool focusIn ) const;
         
         //* group box
         void renderGroupBox( QPainter*, const QRect&, const QColor& color, const bool mouseOver ) const;
@@ -240,6 +342,9 @@ namespace Lightly
         //* progress bar contents (animated)
         void renderProgressBarBusyContents( QPainter* painter, const QRect& rect, const QColor& first, const QColor& second, bool horizontal, bool reverse, int progress  ) const;
 
+        //* cached stripe pattern for busy progress bars. Animation phases are obtained by translating the brush
+        QPixmap progressBarBusyStripe( const QColor& first, const QColor& second, bool horizontal ) const;
+
         //* scrollbar groove
         void renderScrollBarGroove( QPainter* painter, const QRect& rect, const QColor& color ) const
         { return renderScrollBarHandle( painter, rect, color ); }
@@ -331,6 +436,21 @@ namespace Lightly
         KStatefulBrush _windowAlternateBackgroundBrush;
         //@}
 
+        //* widget shadow tilesets, with cost expressed in bytes
+        mutable QCache<ShadowCacheKey, TileSet> _shadowCache;
+
+        //* top highlight tilesets, keyed by color, radius and device pixel ratio
+        mutable QCache<quint64, TileSet> _highlightCache;
+
+        //* line edit focus ring tilesets, keyed by color, radius, animation direction and device pixel ratio
+        mutable QCache<quint64, QVector<TileSet>> _focusRingCache;
+
+        //* ellipse shadows for checkboxes, radio buttons and slider handles
+        mutable QCache<EllipseShadowCacheKey, QPixmap> _ellipseShadowCache;
+
+        //* busy progress bar stripe patterns, keyed by color pair and orientation
+        mutable QCache<QPair<quint64, bool>, QPixmap> _busyStripeCache;
+
         //*@name windeco colors
         //@{
         QColor _activeTitleBarColor;
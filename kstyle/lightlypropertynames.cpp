@@ -31,5 +31,6 @@ namespace Lightly
     const char PropertyNames::toolButtonAlignment[] = "_kde_toolButton_alignment";
     const char PropertyNames::menuTitle[] = "_lightly_toolButton_menutitle";
     const char PropertyNames::alteredBackground[] = "_lightly_altered_background";
+    const char PropertyNames::backgroundFill[] = "_lightly_background_fill";
 
 }
@@ -34,6 +34,7 @@ namespace Lightly
         static const char toolButtonAlignment[];
         static const char menuTitle[];
         static const char alteredBackground[];
+        static const char backgroundFill[];
     };
 
 }
@@ -245,23 +245,23 @@ namespace Lightly
         shadowRenderer.addShadow(params.shadow3.offset, params.shadow3.radius,
             withOpacity(color, params.shadow3.opacity * strength));
 
-        QImage shadowTexture = shadowRenderer.render();
+        // all shadows share the same tint, render them as an alpha mask
+        QImage shadowMask = shadowRenderer.renderMask();
 
-        const QRect outerRect(QPoint(0, 0), shadowTexture.size() / dpr);
+        const QRect outerRect(QPoint(0, 0), shadowMask.size() / dpr);
 
         QRect boxRect(QPoint(0, 0), boxSize);
         boxRect.moveCenter(outerRect.center());
 
-        // Mask out inner rect.
-        QPainter painter(&shadowTexture);
-        painter.setRenderHint(QPainter::Antialiasing);
-
         const QMargins margins = QMargins(
             boxRect.left() - outerRect.left() - Metrics::Shadow_Overlap - params.offset.x(),
             boxRect.top() - outerRect.top() - Metrics::Shadow_Overlap - params.offset.y(),
             outerRect.right() - boxRect.right() - Metrics::Shadow_Overlap + params.offset.x(),
             outerRect.bottom() - boxRect.bottom() - Metrics::Shadow_Overlap + params.offset.y());
 
+        // Mask out inner rect.
+        QPainter painter(&shadowMask);
+        painter.setRenderHint(QPainter::Antialiasing);
         painter.setPen(Qt::NoPen);
         painter.setBrush(Qt::black);
         painter.setCompositionMode(QPainter::CompositionMode_DestinationOut);
@@ -269,8 +269,14 @@ namespace Lightly
             outerRect - margins,
             frameRadius,
             frameRadius);
-        
+        painter.end();
+
+        // Colorize.
+        QImage shadowTexture = BoxShadowRenderer::colorize(shadowMask, QColor(color.rgb()));
+
         // Draw outline.
+        painter.begin(&shadowTexture);
+        painter.setRenderHint(QPainter::Antialiasing);
         painter.setPen(withOpacity(Qt::black, 0.1 * strength));
         painter.setBrush(Qt::NoBrush);
         painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
@@ -293,7 +299,7 @@ namespace Lightly
     }
     
     //_______________________________________________________
-    TileSet ShadowHelper::shadowTiles( const int frameRadius, CustomShadowParams shadow1, CustomShadowParams shadow2 )
+    TileSet ShadowHelper::shadowTiles( const int frameRadius, CustomShadowParams shadow1, CustomShadowParams shadow2, BoxShadowRenderer::Algorithm algorithm )
     {
 
         if (shadow1.radius == 0) {
@@ -315,6 +321,7 @@ namespace Lightly
         const qreal dpr = qApp->devicePixelRatio();
 
         BoxShadowRenderer shadowRenderer;
+        shadowRenderer.setAlgorithm(algorithm);
         shadowRenderer.setBorderRadius(frameRadius);
         shadowRenderer.setBoxSize(boxSize);
         shadowRenderer.setDevicePixelRatio(dpr);
@@ -323,7 +330,9 @@ namespace Lightly
         if (shadow2.radius > 0) 
             shadowRenderer.addShadow(shadow2.offset, shadow2.radius, shadow2.color);
 
-        QImage shadowTexture = shadowRenderer.render();
+        // shadows sharing the same tint are rendered as an alpha mask, and colorized once
+        const bool useMask( shadow2.radius == 0 || shadow1.color.rgb() == shadow2.color.rgb() );
+        QImage shadowTexture = useMask ? shadowRenderer.renderMask() : shadowRenderer.render();
 
         const QRect outerRect(QPoint(0, 0), shadowTexture.size() / dpr);
 
@@ -362,6 +371,9 @@ namespace Lightly
             painter.end();
         }
 
+        if( useMask )
+        { shadowTexture = BoxShadowRenderer::colorize(shadowTexture, QColor(shadow1.color.rgb())); }
+
         const QPoint innerRectTopLeft = outerRect.center();
         TileSet shadowTiles = TileSet(
             QPixmap::fromImage(shadowTexture),
@@ -21,6 +21,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA .        *
  *************************************************************************/
 
+#include "lightlyboxshadowrenderer.h"
 #include "lightlytileset.h"
 
 #include <KWindowShadow>
@@ -125,7 +126,7 @@ namespace Lightly
         //* shadow tiles
         /** is public because it is also needed for mdi windows */
         TileSet shadowTiles();
-        static TileSet shadowTiles( const int frameRadius, CustomShadowParams shadow1, CustomShadowParams shadow2 = CustomShadowParams() );
+        static TileSet shadowTiles( const int frameRadius, CustomShadowParams shadow1, CustomShadowParams shadow2 = CustomShadowParams(), BoxShadowRenderer::Algorithm = BoxShadowRenderer::BoxBlur );
 
         protected Q_SLOTS:
 
@@ -21,7 +21,6 @@
 
 #include "lightly.h"
 #include "lightlyanimations.h"
-#include "lightlyframeshadow.h"
 #include "lightlymdiwindowshadow.h"
 #include "lightlymnemonics.h"
 #include "lightlypropertynames.h"
@@ -52,6 +51,7 @@
 #include <QMenuBar>
 #include <QMap>
 #include <QPainter>
+#include <QPaintEvent>
 #include <QPushButton>
 #include <QRadioButton>
 #include <QScrollBar>
@@ -174,7 +174,6 @@ namespace Lightly
         , _mnemonics( new Mnemonics( this ) )
         , _blurHelper( new BlurHelper( this ) )
         , _windowManager( new WindowManager( this ) )
-        , _frameShadowFactory( new FrameShadowFactory( this ) )
         , _mdiWindowShadowFactory( new MdiWindowShadowFactory( this ) )
         , _splitterFactory( new SplitterFactory( this ) )
         , _widgetExplorer( new WidgetExplorer( this ) )
@@ -243,6 +242,9 @@ namespace Lightly
             _isOpaque = true;
         if(_translucentWidgets.size() > 0) _translucentWidgets.clear();
 
+        // konsole's unified tab bar is painted translucent, but is not tracked by the blur helper
+        _blurHelper->setOpaqueRegionEnabled( !( _isKonsole && StyleConfigData::unifiedTabBarKonsole() ) );
+
         // base class polishing
         ParentStyleClass::polish( app );
     }
@@ -255,11 +257,33 @@ namespace Lightly
          // register widget to animations
         _animations->registerWidget( widget );
         _windowManager->registerWidget( widget );
-        _frameShadowFactory->registerWidget( widget, *_helper );
         _mdiWindowShadowFactory->registerWidget( widget );
         _shadowHelper->registerWidget( widget );
         _splitterFactory->registerWidget( widget );
 
+        // classify widget once, so that event filters and rendering need not walk the metaobject
+        WidgetRoles roles( classifyWidget( widget ) );
+
+        // toolbars embedding a tabbar are not styled as toolbars (Kaffeine's sidebar)
+        if( qobject_cast<QToolBar*>( widget ) && widget->findChild<QTabBar*>() ) roles |= RoleToolBarWithTabBar;
+        else if( qobject_cast<QTabBar*>( widget ) )
+        {
+            // tabbars added after the toolbar was polished
+            for( QWidget* parent = widget->parentWidget(); parent && !parent->isWindow(); parent = parent->parentWidget() )
+            { if( qobject_cast<QToolBar*>( parent ) ) addWidgetRoles( parent, RoleToolBarWithTabBar ); }
+        }
+
+        // widgets with no role are cached too, so that lookups never fall back to classifyWidget.
+        // Roles added while polishing the parent (scrollbar containers) are kept
+        auto iter( _widgetRoles.find( widget ) );
+        if( iter != _widgetRoles.end() ) iter.value() |= roles;
+        else {
+
+            connect( widget, &QObject::destroyed, this, &Style::widgetDestroyed );
+            _widgetRoles.insert( widget, roles );
+
+        }
+
         // enable mouse over effects for all necessary widgets
         if(
             qobject_cast<QAbstractItemView*>( widget )
@@ -276,7 +300,7 @@ namespace Lightly
             || qobject_cast<QTabBar*>( widget )
             || qobject_cast<QTextEdit*>( widget )
             || qobject_cast<QToolButton*>( widget )
-            || widget->inherits( "KTextEditor::View" )
+            || (roles & RoleTextEditorView)
             )
         { widget->setAttribute( Qt::WA_Hover ); }
         
@@ -318,7 +342,7 @@ namespace Lightly
 
                 else if (widget->inherits("QTipLabel")
                     || qobject_cast<QLabel*>(widget) // a floating label, as in Filelight
-                    || widget->inherits("QComboBoxPrivateContainer") // at most, a menu
+                    || (roles & RoleComboBoxContainer) // at most, a menu
                     /* like Vokoscreen's (old) QvkRegionChoise */
                     || (widget->windowFlags().testFlag(Qt::WindowStaysOnTopHint)
                         && widget->testAttribute(Qt::WA_NoSystemBackground)
@@ -411,7 +435,7 @@ namespace Lightly
             // remove opaque painting for scrollbars
             widget->setAttribute( Qt::WA_OpaquePaintEvent, false );
 
-        } else if( widget->inherits( "KTextEditor::View" ) ) {
+        } else if( roles & RoleTextEditorView ) {
 
             addEventFilter( widget );
 
@@ -437,6 +461,14 @@ namespace Lightly
             widget->setContentsMargins( Metrics::Frame_FrameWidth, Metrics::Frame_FrameWidth, Metrics::Frame_FrameWidth, Metrics::Frame_FrameWidth );
             addEventFilter( widget );
 
+            // register dolphin sidebars
+            static const QRegularExpression sideDockName( QStringLiteral( "^(places|terminal|info|folders)Dock$" ) );
+            if( _isDolphin && sideDockName.match( widget->objectName() ).hasMatch() && !_dolphinSideDocks.contains( widget ) )
+            {
+                _dolphinSideDocks.removeAll( nullptr );
+                _dolphinSideDocks.append( widget );
+            }
+
         } else if( qobject_cast<QMdiSubWindow*>( widget ) ) {
 
             widget->setAutoFillBackground( false );
@@ -474,7 +506,7 @@ namespace Lightly
                 { itemView->setItemDelegate( new LightlyPrivate::ComboBoxItemDelegate( itemView ) ); }
             }
 
-        } else if( widget->inherits( "QComboBoxPrivateContainer" ) ) {
+        } else if( roles & RoleComboBoxContainer ) {
 
             addEventFilter( widget );
             setTranslucentBackground( widget );
@@ -501,15 +533,26 @@ namespace Lightly
         if( scrollArea->frameShadow() == QFrame::Sunken && scrollArea->focusPolicy()&Qt::StrongFocus )
         { scrollArea->setAttribute( Qt::WA_Hover ); }
 
-        if( scrollArea->viewport() && scrollArea->inherits( "KItemListContainer" ) && scrollArea->frameShape() == QFrame::NoFrame )
+        if( scrollArea->viewport() && (widgetRoles( scrollArea ) & RoleItemListContainer) && scrollArea->frameShape() == QFrame::NoFrame )
         {
             scrollArea->viewport()->setBackgroundRole( QPalette::Window );
             scrollArea->viewport()->setForegroundRole( QPalette::WindowText );
         }
 
-        // add event filter, to make sure proper background is rendered behind scrollbars
+        // add event filter, to forward mouse events from the frame to the scrollbars
         addEventFilter( scrollArea );
 
+        // track vertical scrollbar visibility in item list containers, for dolphin separators.
+        // The container is created together with the scrollarea, so that it needs not be searched for at paint time
+        if( widgetRoles( scrollArea ) & RoleItemListContainer )
+        {
+            if( auto container = scrollArea->findChild<QWidget*>( QStringLiteral( "qt_scrollarea_vcontainer" ), Qt::FindDirectChildrenOnly ) )
+            {
+                addWidgetRoles( container, RoleItemListScrollBarContainer );
+                addEventFilter( container );
+            }
+        }
+
         // force side panels as flat, on option
         if( scrollArea->inherits( "KDEPrivate::KPageListView" ) || scrollArea->inherits( "KDEPrivate::KPageTreeView" ) )
         { scrollArea->setProperty( PropertyNames::sidePanelView, true ); }
@@ -569,7 +612,6 @@ namespace Lightly
 
         // register widget to animations
         _animations->unregisterWidget( widget );
-        _frameShadowFactory->unregisterWidget( widget );
         _mdiWindowShadowFactory->unregisterWidget( widget );
         _shadowHelper->unregisterWidget( widget );
         _windowManager->unregisterWidget( widget );
@@ -580,8 +622,15 @@ namespace Lightly
         if( qobject_cast<QAbstractScrollArea*>( widget ) ||
             qobject_cast<QDockWidget*>( widget ) ||
             qobject_cast<QMdiSubWindow*>( widget ) ||
-            widget->inherits( "QComboBoxPrivateContainer" ) )
+            (widgetRoles( widget ) & (RoleComboBoxContainer|RoleItemListScrollBarContainer)) )
             { widget->removeEventFilter( this ); }
+
+        // remove from role cache
+        if( _widgetRoles.remove( widget ) )
+        { disconnect( widget, &QObject::destroyed, this, &Style::widgetDestroyed ); }
+
+        // remove from dolphin sidebars
+        _dolphinSideDocks.removeAll( widget );
             
         if ( _translucentWidgets.contains( widget ) )
         {
@@ -625,7 +674,7 @@ namespace Lightly
 
             }
             
-            else if( widget && widget->inherits( "KTextEditor::View" ) && !StyleConfigData::kTextEditDrawFrame() && !_isKdevelop ) return 0;
+            else if( (widgetRoles( widget ) & RoleTextEditorView) && !StyleConfigData::kTextEditDrawFrame() && !_isKdevelop ) return 0;
             
             // from kvantum
             else if ( widget && _isDolphin )
@@ -1174,12 +1223,15 @@ namespace Lightly
         else if( object == qApp && event->type() == QEvent::ApplicationPaletteChange ) { configurationChanged(); }
         #endif
         // cast to QWidget
+        if( !object->isWidgetType() ) return ParentStyleClass::eventFilter( object, event );
         QWidget *widget = static_cast<QWidget*>( object );
-        if( widget->inherits( "QAbstractScrollArea" ) || widget->inherits( "KTextEditor::View" ) ) { return eventFilterScrollArea( widget, event ); }
-        else if( widget->inherits( "QComboBoxPrivateContainer" ) ) { return eventFilterComboBoxContainer( widget, event ); }
+        const WidgetRoles roles( widgetRoles( widget ) );
+        if( roles & RoleScrollArea ) { return eventFilterScrollArea( widget, event ); }
+        else if( roles & RoleItemListScrollBarContainer ) { return eventFilterScrollBarContainer( widget, event ); }
+        else if( roles & RoleComboBoxContainer ) { return eventFilterComboBoxContainer( widget, event ); }
         
         // paint background
-        if ( widget && event->type() == QEvent::Paint ) {
+        if ( event->type() == QEvent::Paint ) {
             if (widget->isWindow() 
                 && !_isKonsole
                 && widget->testAttribute( Qt::WA_StyledBackground )
@@ -1193,12 +1245,25 @@ namespace Lightly
                     case Qt::Sheet: {
                         if ( qobject_cast<QMenu*>( widget ) ) break;
                         if ( !_translucentWidgets.contains( widget ) ) break;
+                        
+                        // only fill the exposed rects. Qt already removed opaque children from the event region
+                        const QRegion& region( static_cast<QPaintEvent*>( event )->region() );
+                        const QColor& color( widget->palette().color( QPalette::Window ) );
                         QPainter p( widget );
-                        p.setClipRegion(static_cast<QPaintEvent*>( event )->region());
-                        p.fillRect( widget->rect(), QColor( widget->palette().color( QPalette::Window ) ) );
+                        qint64 pixels( 0 );
+                        for( const QRect& rect : region )
+                        {
+                            p.fillRect( rect, color );
+                            pixels += qint64( rect.width() )*rect.height();
+                        }
+                        
+                        // expose filled area to the widget explorer
+                        if( _widgetExplorer->enabled() )
+                        { widget->setProperty( PropertyNames::backgroundFill, pixels ); }
                         
                         // separator between the window and decoration
-                        if( _helper->titleBarColor( true ).alphaF()*100.0 < 100 && !_isKonsole)
+                        if( _helper->titleBarColor( true ).alphaF()*100.0 < 100 && !_isKonsole
+                            && region.intersects( QRect( 0, 0, widget->width(), 1 ) ) )
                         {
                             p.setBrush( Qt::NoBrush );
                             p.setPen( QColor( 0,0,0,40 ) );
@@ -1228,17 +1293,14 @@ namespace Lightly
         }
 
         // update blur region if window is not completely transparent
-        if( widget && widget->inherits( "QWidget" ) )
+        if( widget->palette().color( QPalette::Window ).alpha() == 255 )
         {
-            if( widget->palette().color( QPalette::Window ).alpha() == 255 )
+            if( ( qobject_cast<QToolBar*>( widget ) || qobject_cast<QMenuBar*>( widget )) && _helper->titleBarColor( true ).alphaF() < 1.0 )
             {
-                if( ( qobject_cast<QToolBar*>( widget ) || qobject_cast<QMenuBar*>( widget )) && _helper->titleBarColor( true ).alphaF() < 1.0 )
+                if( event->type() == QEvent::Move  || event->type() == QEvent::Show || event->type() == QEvent::Hide )
                 {
-                    if( event->type() == QEvent::Move  || event->type() == QEvent::Show || event->type() == QEvent::Hide )
-                    {
-                        if( _translucentWidgets.contains( widget->window() ) && !_isKonsole )
-                            _blurHelper->forceUpdate( widget->window() );
-                    }
+                    if( _translucentWidgets.contains( widget->window() ) && !_isKonsole )
+                        _blurHelper->forceUpdate( widget->window() );
                 }
             }
         }
@@ -1272,79 +1334,7 @@ namespace Lightly
     {
 
         switch( event->type() )
-        {   // TODO: delete
-            case QEvent::Paint:
-            {
-
-                // get scrollarea viewport
-                auto scrollArea( qobject_cast<QAbstractScrollArea*>( widget ) );
-                QWidget* viewport;
-                if( !( scrollArea && (viewport = scrollArea->viewport()) ) ) break;
-
-                // get scrollarea horizontal and vertical containers
-                QWidget* child( nullptr );
-                QList<QWidget*> children;
-                if( ( child = scrollArea->findChild<QWidget*>( "qt_scrollarea_vcontainer" ) ) )
-                { 
-                    if( child->isVisible() ){
-                        children.append( child );
-                        
-                        if( scrollArea->inherits( "KItemListContainer" ) )
-                        {
-                            QWidget *parent = scrollArea->parentWidget();
-                            if( parent && parent->inherits( "DolphinView" ) ){
-                                // update if needed
-                                if( !scrollArea->property("VISIBLE-SEPARATORS").toBool() ) {
-                                    scrollArea->setProperty( "VISIBLE-SEPARATORS", true );
-                                    scrollArea->update();
-                                }
-                            }
-                        }
-                    }
-                    else
-                    {
-                        if( scrollArea->inherits( "KItemListContainer" ) )
-                        {
-                            QWidget *parent = scrollArea->parentWidget();
-                            if( parent && parent->inherits( "DolphinView" ) )
-                            {
-                                // update if needed
-                                if( scrollArea->property("VISIBLE-SEPARATORS").toBool() ) {
-                                    scrollArea->setProperty( "VISIBLE-SEPARATORS", false );
-                                    scrollArea->update();
-                                }
-                            }
-                        }
-                    }
-                    
-                }
-
-                if( ( child = scrollArea->findChild<QWidget*>( "qt_scrollarea_hcontainer" ) ) && child->isVisible() )
-                { children.append( child ); }
-
-                if( children.empty() ) break;
-                if( !scrollArea->styleSheet().isEmpty() ) break;
-
-                // make sure proper background is rendered behind the containers
-                QPainter painter( scrollArea );
-                painter.setClipRegion( static_cast<QPaintEvent*>( event )->region() );
-
-                painter.setPen( Qt::NoPen );
-
-                // decide background color
-                const QPalette::ColorRole role( viewport->backgroundRole() );
-                QColor background;
-                if( role == QPalette::Window && hasAlteredBackground( viewport ) ) background = _helper->frameBackgroundColor( viewport->palette() );
-                else background = viewport->palette().color( role );
-                painter.setBrush( background );
-
-                // render
-                //foreach( auto* child, children )
-                //{ painter.drawRect( child->geometry() ); }
-
-            }
-            break;
-
+        {
             case QEvent::MouseButtonPress:
             case QEvent::MouseButtonRelease:
             case QEvent::MouseMove:
@@ -1364,7 +1354,7 @@ namespace Lightly
                     if( scrollArea->horizontalScrollBarPolicy() != Qt::ScrollBarAlwaysOff ) scrollBars.append( scrollArea->horizontalScrollBar() );
                     if( scrollArea->verticalScrollBarPolicy() != Qt::ScrollBarAlwaysOff )scrollBars.append( scrollArea->verticalScrollBar() );
 
-                } else if( widget->inherits( "KTextEditor::View" ) ) {
+                } else if( widgetRoles( widget ) & RoleTextEditorView ) {
 
                     scrollBars = widget->findChildren<QScrollBar*>();
 
@@ -1411,6 +1401,30 @@ namespace Lightly
 
     }
 
+    //_________________________________________________________
+    bool Style::eventFilterScrollBarContainer( QWidget* widget, QEvent* event )
+    {
+
+        if( event->type() != QEvent::Show && event->type() != QEvent::Hide )
+        { return ParentStyleClass::eventFilter( widget, event ); }
+
+        // dolphin views draw separators around their contents when the vertical scrollbar is visible
+        QWidget* scrollArea( widget->parentWidget() );
+        if( !( scrollArea && ( widgetRoles( scrollArea->parentWidget() ) & RoleDolphinView ) ) )
+        { return ParentStyleClass::eventFilter( widget, event ); }
+
+        // only explicit visibility matters, not the one inherited from hidden parents
+        const bool visible( widget->isVisibleTo( scrollArea ) );
+        if( scrollArea->property( "VISIBLE-SEPARATORS" ).toBool() != visible )
+        {
+            scrollArea->setProperty( "VISIBLE-SEPARATORS", visible );
+            scrollArea->update();
+        }
+
+        return ParentStyleClass::eventFilter( widget, event );
+
+    }
+
     //_________________________________________________________
     bool Style::eventFilterComboBoxContainer( QWidget* widget, QEvent* event )
     {
@@ -1709,6 +1723,55 @@ namespace Lightly
 
     }
 
+    //_____________________________________________________________________
+    void Style::widgetDestroyed( QObject* object )
+    { _widgetRoles.remove( object ); }
+
+    //_____________________________________________________________________
+    void Style::addWidgetRoles( QWidget* widget, WidgetRoles roles )
+    {
+
+        auto iter( _widgetRoles.find( widget ) );
+        if( iter != _widgetRoles.end() ) iter.value() |= roles;
+        else {
+
+            connect( widget, &QObject::destroyed, this, &Style::widgetDestroyed );
+            _widgetRoles.insert( widget, classifyWidget( widget )|roles );
+
+        }
+
+    }
+
+    //_____________________________________________________________________
+    Style::WidgetRoles Style::classifyWidget( const QObject* object )
+    {
+
+        WidgetRoles roles;
+        if( !object ) return roles;
+
+        if( object->inherits( "QAbstractScrollArea" ) )
+        {
+
+            roles |= RoleScrollArea;
+            if( object->inherits( "KItemListContainer" ) ) roles |= RoleItemListContainer;
+            else if( object->inherits( "QComboBoxListView" ) ) roles |= RoleComboBoxListView;
+
+        } else if( object->inherits( "KTextEditor::View" ) ) {
+
+            // text editor views are handled as scrollareas in the event filter
+            roles |= RoleScrollArea;
+            roles |= RoleTextEditorView;
+
+        }
+        else if( object->inherits( "QComboBoxPrivateContainer" ) ) roles |= RoleComboBoxContainer;
+        else if( object->inherits( "DolphinView" ) ) roles |= RoleDolphinView;
+        else if( object->inherits( "QTableCornerButton" ) ) roles |= RoleTableCornerButton;
+        else if( object->inherits( "QDockWidgetTitleButton" ) ) roles |= RoleDockWidgetTitleButton;
+
+        return roles;
+
+    }
+
     //____________________________________________________________________
     QIcon Style::standardIconImplementation( StandardPixmap standardPixmap, const QStyleOption* option, const QWidget* widget ) const
     {
@@ -1761,6 +1824,9 @@ namespace Lightly
         //update blurhelper
         _blurHelper->setTranslucentTitlebar( _helper->titleBarColor( true ).alphaF() < 1.0 ? true : false );
 
+        // konsole's unified tab bar is painted translucent, but is not tracked by the blur helper
+        _blurHelper->setOpaqueRegionEnabled( !( _isKonsole && StyleConfigData::unifiedTabBarKonsole() ) );
+
         // reinitialize engines
         _animations->setupEngines();
         _windowManager->initialize();
@@ -3460,15 +3526,6 @@ namespace Lightly
 
         } else {
 
-            /*if( _frameShadowFactory->isRegistered( widget ) ) // WHAT does this do??
-            {
-
-                // update frame shadow factory
-                _frameShadowFactory->updateShadowsGeometry( widget, rect );
-                _frameShadowFactory->updateState( widget, hasFocus, mouseOver, opacity, mode );
-
-            }*/
-
             const auto background( isTitleWidget ? palette.color( widget->backgroundRole() ) : palette.color( QPalette::Base ) );
             _helper->renderFrame( painter, rect, background, palette, windowActive, enabled );
 
@@ -3534,7 +3591,7 @@ namespace Lightly
         { return true; }
 
         // no focus indicator on ComboBox list items
-        if (widget && widget->inherits("QComboBoxListView"))
+        if( widgetRoles( widget ) & RoleComboBoxListView )
         { return true; }
 
         if ( option->styleObject && option->styleObject->property("elementType") == QLatin1String("button") )
@@ -5531,9 +5588,11 @@ namespace Lightly
                 // adjust shadow rect if there is no widget "above" (z) the toolbar
                 if( _isDolphin && StyleConfigData::dolphinSidebarOpacity() < 100 )
                 {
-                    QList<QWidget *> sidebars = widget->window()->findChildren<QWidget *>( QRegularExpression("^(places|terminal|info|folders)Dock$"), Qt::FindDirectChildrenOnly );
-                    for( auto sb : sidebars )
+                    for( const auto& sb : _dolphinSideDocks )
                     {
+                        // only consider direct children of the toolbar window
+                        if( !sb || sb->parentWidget() != widget->window() ) continue;
+
                         // directly bellow the toolbar
                         if( sb->isVisible() && sb->y() == widget->y() + widget->height() )
                         {
@@ -5645,12 +5704,17 @@ namespace Lightly
 
         }
 
+        // render contents
+        progressBarOption2.rect = subElementRect( SE_ProgressBarContents, progressBarOption, widget );
+
         // check if animated and pass to option
+        // also store contents rect, so that busy animation ticks only repaint that
         if( _animations->busyIndicatorEngine().isAnimated( styleObject ) )
-        { progressBarOption2.progress = _animations->busyIndicatorEngine().value(); }
+        {
+            progressBarOption2.progress = _animations->busyIndicatorEngine().value();
+            _animations->busyIndicatorEngine().setContentsRect( styleObject, progressBarOption2.rect );
+        }
 
-        // render contents
-        progressBarOption2.rect = subElementRect( SE_ProgressBarContents, progressBarOption, widget );
         drawControl( CE_ProgressBarContents, &progressBarOption2, painter, widget );
 
         // render text
@@ -6080,7 +6144,7 @@ namespace Lightly
 
         const bool horizontal( headerOption->orientation == Qt::Horizontal );
         const bool isFirst( horizontal && ( headerOption->position == QStyleOptionHeader::Beginning ) );
-        const bool isCorner( widget && widget->inherits( "QTableCornerButton" ) );
+        const bool isCorner( widgetRoles( widget ) & RoleTableCornerButton );
         const bool reverseLayout( option->direction == Qt::RightToLeft );
 
         // update animation state
@@ -6993,7 +7057,7 @@ namespace Lightly
 
             // detect dock widget title button
             // for dockwidget title buttons, do not take out margins, so that icon do not get scaled down
-            const bool isDockWidgetTitleButton( widget && widget->inherits( "QDockWidgetTitleButton" ) );
+            const bool isDockWidgetTitleButton( widgetRoles( widget ) & RoleDockWidgetTitleButton );
             if( isDockWidgetTitleButton )
             {
 
@@ -7737,7 +7801,7 @@ namespace Lightly
 
             return scrollArea;
 
-        } else if( widget->parentWidget()->inherits( "KTextEditor::View" ) ) {
+        } else if( widgetRoles( widget->parentWidget() ) & RoleTextEditorView ) {
 
             return widget->parentWidget();
 
@@ -8113,12 +8177,13 @@ namespace Lightly
         if( property.isValid() ) return property.toBool();
 
         // detect menu toolbuttons
-        QWidget* parent = widget->parentWidget();
-        if( qobject_cast<QMenu*>( parent ) )
+        // only the menu actions need to be checked, rather than all its descendants
+        if( const auto menu = qobject_cast<QMenu*>( widget->parentWidget() ) )
         {
-            foreach( auto child, parent->findChildren<QWidgetAction*>() )
+            foreach( auto action, menu->actions() )
             {
-                if( child->defaultWidget() != widget ) continue;
+                const auto child( qobject_cast<QWidgetAction*>( action ) );
+                if( !child || child->defaultWidget() != widget ) continue;
                 const_cast<QWidget*>(widget)->setProperty( PropertyNames::menuTitle, true );
                 return true;
             }
@@ -8267,11 +8332,8 @@ namespace Lightly
             return false;
         }
         
-        if (QTabBar *tabBar = w->findChild<QTabBar*>())
-        {
-            if (tb->isAncestorOf(tabBar))
+        if (widgetRoles(w) & RoleToolBarWithTabBar)
             return false; // practically not a toolbar (Kaffeine's sidebar)
-        }
         
         QWidget *p = w->parentWidget();
         if (p != w->window()) return false; // inside a dock
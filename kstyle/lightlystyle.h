@@ -38,6 +38,7 @@
 #include <QIcon>
 #include <QMdiSubWindow>
 #include <QStyleOption>
+#include <QVector>
 #include <QWidget>
 
 #include <functional>
@@ -51,7 +52,6 @@ namespace Lightly
 {
 
     class Animations;
-    class FrameShadowFactory;
     class Helper;
     class MdiWindowShadowFactory;
     class Mnemonics;
@@ -138,6 +138,7 @@ namespace Lightly
 
         bool eventFilter(QObject *, QEvent *) override;
         bool eventFilterScrollArea( QWidget*, QEvent* );
+        bool eventFilterScrollBarContainer( QWidget*, QEvent* );
         bool eventFilterComboBoxContainer( QWidget*, QEvent* );
         bool eventFilterDockWidget( QDockWidget*, QEvent* );
         bool eventFilterMdiSubWindow( QMdiSubWindow*, QEvent* );
@@ -160,6 +161,9 @@ namespace Lightly
         //* standard icons
         QIcon standardIconImplementation( StandardPixmap, const QStyleOption*, const QWidget* ) const;
 
+        //* remove destroyed widget from role cache
+        void widgetDestroyed( QObject* );
+
         protected:
 
         //* standard icons
@@ -171,6 +175,43 @@ namespace Lightly
         //* load configuration
         void loadConfiguration();
 
+        //*@name widget role classification
+        //@{
+
+        //* widget roles, resolved once from the widget metaobject at polish time
+        enum WidgetRole
+        {
+            RoleNone = 0,
+            RoleScrollArea = 1<<0,
+            RoleTextEditorView = 1<<1,
+            RoleComboBoxContainer = 1<<2,
+            RoleComboBoxListView = 1<<3,
+            RoleItemListContainer = 1<<4,
+            RoleDolphinView = 1<<5,
+            RoleTableCornerButton = 1<<6,
+            RoleDockWidgetTitleButton = 1<<7,
+            RoleToolBarWithTabBar = 1<<8,
+            RoleItemListScrollBarContainer = 1<<9
+        };
+
+        Q_DECLARE_FLAGS( WidgetRoles, WidgetRole )
+
+        //* classify widget, using its metaobject
+        static WidgetRoles classifyWidget( const QObject* );
+
+        //* add roles to widget cache
+        void addWidgetRoles( QWidget*, WidgetRoles );
+
+        //* cached widget roles, including RoleNone. Falls back to classifyWidget for never polished objects
+        WidgetRoles widgetRoles( const QObject* object ) const
+        {
+            if( !object ) return RoleNone;
+            const auto iter( _widgetRoles.constFind( object ) );
+            return iter != _widgetRoles.constEnd() ? iter.value() : classifyWidget( object );
+        }
+
+        //@}
+
         //*@name subelementRect specialized functions
         //@{
 
@@ -512,9 +553,6 @@ namespace Lightly
         //* window manager
         WindowManager* _windowManager = nullptr;
 
-        //* frame shadows
-        FrameShadowFactory* _frameShadowFactory = nullptr;
-
         //* mdi window shadows
         MdiWindowShadowFactory* _mdiWindowShadowFactory = nullptr;
 
@@ -531,6 +569,12 @@ namespace Lightly
         using IconCache = QHash<StandardPixmap, QIcon>;
         IconCache _iconCache;
 
+        //* widget roles, as computed in ::polish
+        QHash<const QObject*, WidgetRoles> _widgetRoles;
+
+        //* dolphin sidebar docks, as registered in ::polish, so that toolbar painting needs not search the window for them
+        QVector<WeakPointer<QWidget>> _dolphinSideDocks;
+
         //* pointer to primitive specialized function
         using StylePrimitive = std::function<bool(const Style&, const QStyleOption*, QPainter*, const QWidget*)>;
         StylePrimitive _frameFocusPrimitive;
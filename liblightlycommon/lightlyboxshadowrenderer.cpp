@@ -25,9 +25,33 @@
 #include <QPainter>
 #include <QtMath>
 #include <QDebug>
+
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && defined(__SSE2__)
+#define LIGHTLY_BLUR_X86 1
+#include <immintrin.h>
+#else
+#define LIGHTLY_BLUR_X86 0
+#endif
+
 namespace Lightly
 {
 
+/**
+ * Offset of the alpha byte within a pixel.
+ *
+ * @param image Either an ARGB32 image or an alpha-only image.
+ **/
+static inline int alphaOffset(const QImage &image)
+{
+    if (image.depth() == 8) {
+        return 0;
+    }
+
+    return QSysInfo::ByteOrder == QSysInfo::BigEndian ? 0 : 3;
+}
+
 static inline int calculateBlurRadius(qreal stdDev)
 {
     // See https://www.w3.org/TR/SVG11/filters.html#feGaussianBlurElement
@@ -100,6 +124,30 @@ static QVector<BoxLobes> computeLobes(int radius)
     };
 }
 
+/**
+ * Compute the standard deviation of the three box filters combined.
+ *
+ * It is larger than calculateBlurStdDev(radius), so the analytic shadow uses
+ * it to match the spread of the box blur.
+ *
+ * @param radius The blur radius, in device pixels.
+ **/
+static qreal calculateBoxBlurStdDev(int radius)
+{
+    // The box blur is skipped for smaller radii.
+    if (radius < 2) {
+        return 0.0;
+    }
+
+    qreal variance = 0.0;
+    for (const BoxLobes &lobe : computeLobes(radius)) {
+        const int boxSize = lobe.left + 1 + lobe.right;
+        variance += (boxSize * boxSize - 1) / 12.0;
+    }
+
+    return std::sqrt(variance);
+}
+
 /**
  * Process a row with a box filter.
  *
@@ -166,25 +214,209 @@ static inline void boxBlurRowAlpha(const uint8_t *src, uint8_t *dst, int width,
     }
 }
 
+#if LIGHTLY_BLUR_X86
+
 /**
- * Blur the alpha channel of a given image.
+ * Walk down a block of adjacent columns, keeping one running sum per column.
  *
- * @param image The input image.
- * @param radius The blur radius.
- * @param rect Specifies what part of the image to blur. If nothing is provided, then
- *    the whole alpha channel of the input image will be blurred.
+ * The loop structure mirrors boxBlurRowAlpha, with the left, center and right
+ * sections of the box filter expressed as row indices. Loading, accumulating and
+ * storing rows is left to the @p Lanes policy, which processes @p Lanes::count
+ * columns at once.
  **/
-static inline void boxBlurAlpha(QImage &image, int radius, const QRect &rect = {})
+template<typename Lanes>
+static inline void boxBlurColumnBlock(const uint8_t *src, uint8_t *dst, int width, int height, const BoxLobes &lobes)
 {
-    if (radius < 2) {
-        return;
+    const int boxSize = lobes.left + 1 + lobes.right;
+    const Lanes reciprocal = Lanes::splat((1 << 24) / boxSize);
+
+    const Lanes first = Lanes::load(src);
+    const Lanes last = Lanes::load(src + (height - 1) * width);
+
+    Lanes sum = Lanes::splat((boxSize + 1) / 2);
+    sum = Lanes::add(sum, Lanes::mul(first, Lanes::splat(lobes.left)));
+    for (int y = 0; y <= lobes.right; ++y) {
+        sum = Lanes::add(sum, Lanes::load(src + y * width));
     }
 
-    const QVector<BoxLobes> lobes = computeLobes(radius);
+    int y = 0;
+    for (; y < lobes.left; ++y) {
+        Lanes::store(dst + y * width, Lanes::scale(sum, reciprocal));
+        sum = Lanes::sub(Lanes::add(sum, Lanes::load(src + (y + lobes.right + 1) * width)), first);
+    }
 
-    const QRect blurRect = rect.isNull() ? image.rect() : rect;
+    for (; y < height - lobes.right - 1; ++y) {
+        Lanes::store(dst + y * width, Lanes::scale(sum, reciprocal));
+        sum = Lanes::sub(Lanes::add(sum, Lanes::load(src + (y + lobes.right + 1) * width)),
+                         Lanes::load(src + (y - lobes.left) * width));
+    }
+
+    for (; y < height; ++y) {
+        Lanes::store(dst + y * width, Lanes::scale(sum, reciprocal));
+        sum = Lanes::sub(Lanes::add(sum, last), Lanes::load(src + (y - lobes.left) * width));
+    }
+}
+
+//* eight columns, as two vectors of four 32-bit sums
+struct Sse2Lanes
+{
+    enum { count = 8 };
+
+    __m128i low;
+    __m128i high;
+
+    static inline Sse2Lanes splat(int value)
+    { return {_mm_set1_epi32(value), _mm_set1_epi32(value)}; }
+
+    static inline Sse2Lanes load(const uint8_t *data)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i words = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(data)), zero);
+        return {_mm_unpacklo_epi16(words, zero), _mm_unpackhi_epi16(words, zero)};
+    }
+
+    static inline void store(uint8_t *data, const Sse2Lanes &value)
+    {
+        const __m128i words = _mm_packs_epi32(value.low, value.high);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(data), _mm_packus_epi16(words, words));
+    }
+
+    static inline Sse2Lanes add(const Sse2Lanes &a, const Sse2Lanes &b)
+    { return {_mm_add_epi32(a.low, b.low), _mm_add_epi32(a.high, b.high)}; }
+
+    static inline Sse2Lanes sub(const Sse2Lanes &a, const Sse2Lanes &b)
+    { return {_mm_sub_epi32(a.low, b.low), _mm_sub_epi32(a.high, b.high)}; }
+
+    // SSE2 has no 32-bit low multiply, multiply even and odd lanes separately
+    static inline __m128i mullo(__m128i a, __m128i b)
+    {
+        const __m128i even = _mm_mul_epu32(a, b);
+        const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                  _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+
+    static inline Sse2Lanes mul(const Sse2Lanes &a, const Sse2Lanes &b)
+    { return {mullo(a.low, b.low), mullo(a.high, b.high)}; }
+
+    static inline Sse2Lanes scale(const Sse2Lanes &sum, const Sse2Lanes &reciprocal)
+    {
+        const Sse2Lanes product = mul(sum, reciprocal);
+        return {_mm_srli_epi32(product.low, 24), _mm_srli_epi32(product.high, 24)};
+    }
+};
+
+static void boxBlurColumnsAlphaSse2(const uint8_t *src, uint8_t *dst, int width, int height, const BoxLobes &lobes)
+{
+    int x = 0;
+    for (; x + Sse2Lanes::count <= width; x += Sse2Lanes::count) {
+        boxBlurColumnBlock<Sse2Lanes>(src + x, dst + x, width, height, lobes);
+    }
+
+    for (; x < width; ++x) {
+        boxBlurRowAlpha(src + x, dst + x, height, 1, width, lobes, true, true);
+    }
+}
+
+//* eight columns, as one vector of eight 32-bit sums
+struct Avx2Lanes
+{
+    enum { count = 8 };
+
+    __m256i value;
+
+    __attribute__((target("avx2"))) static inline Avx2Lanes splat(int value)
+    { return {_mm256_set1_epi32(value)}; }
+
+    __attribute__((target("avx2"))) static inline Avx2Lanes load(const uint8_t *data)
+    { return {_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(data)))}; }
+
+    __attribute__((target("avx2"))) static inline void store(uint8_t *data, const Avx2Lanes &value)
+    {
+        const __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(value.value), _mm256_extracti128_si256(value.value, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(data), _mm_packus_epi16(words, words));
+    }
+
+    __attribute__((target("avx2"))) static inline Avx2Lanes add(const Avx2Lanes &a, const Avx2Lanes &b)
+    { return {_mm256_add_epi32(a.value, b.value)}; }
 
-    const int alphaOffset = QSysInfo::ByteOrder == QSysInfo::BigEndian ? 0 : 3;
+    __attribute__((target("avx2"))) static inline Avx2Lanes sub(const Avx2Lanes &a, const Avx2Lanes &b)
+    { return {_mm256_sub_epi32(a.value, b.value)}; }
+
+    __attribute__((target("avx2"))) static inline Avx2Lanes mul(const Avx2Lanes &a, const Avx2Lanes &b)
+    { return {_mm256_mullo_epi32(a.value, b.value)}; }
+
+    __attribute__((target("avx2"))) static inline Avx2Lanes scale(const Avx2Lanes &sum, const Avx2Lanes &reciprocal)
+    { return {_mm256_srli_epi32(_mm256_mullo_epi32(sum.value, reciprocal.value), 24)}; }
+};
+
+// flatten, so that the lane helpers get inlined in an AVX2 context
+__attribute__((target("avx2"), flatten)) static void boxBlurColumnsAlphaAvx2(const uint8_t *src, uint8_t *dst, int width, int height, const BoxLobes &lobes)
+{
+    int x = 0;
+    for (; x + Avx2Lanes::count <= width; x += Avx2Lanes::count) {
+        boxBlurColumnBlock<Avx2Lanes>(src + x, dst + x, width, height, lobes);
+    }
+
+    for (; x < width; ++x) {
+        boxBlurRowAlpha(src + x, dst + x, height, 1, width, lobes, true, true);
+    }
+}
+
+#else
+
+/**
+ * Process all columns of an 8-bit alpha plane with a box filter.
+ *
+ * This is the reference implementation, the vectorized variants above
+ * produce exactly the same output.
+ *
+ * @param src The source plane.
+ * @param dst The destination plane.
+ * @param width The width of the planes, which is also their stride.
+ * @param height The height of the planes.
+ * @param lobes Params of the box filter.
+ **/
+static void boxBlurColumnsAlphaScalar(const uint8_t *src, uint8_t *dst, int width, int height, const BoxLobes &lobes)
+{
+    for (int x = 0; x < width; ++x) {
+        boxBlurRowAlpha(src + x, dst + x, height, 1, width, lobes, true, true);
+    }
+}
+
+#endif
+
+using BoxBlurColumnsFunction = void (*)(const uint8_t *, uint8_t *, int, int, const BoxLobes &);
+
+/**
+ * Select the fastest column blur supported by the running CPU.
+ **/
+static BoxBlurColumnsFunction boxBlurColumnsAlpha()
+{
+    static const BoxBlurColumnsFunction function = []() -> BoxBlurColumnsFunction {
+#if LIGHTLY_BLUR_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return boxBlurColumnsAlphaAvx2;
+        }
+        return boxBlurColumnsAlphaSse2;
+#else
+        return boxBlurColumnsAlphaScalar;
+#endif
+    }();
+
+    return function;
+}
+
+/**
+ * Blur the alpha channel of a given image in place, walking the image
+ * memory directly.
+ *
+ * Used when the blurred area is smaller than the box filter.
+ **/
+static inline void boxBlurAlphaStrided(QImage &image, const QVector<BoxLobes> &lobes, const QRect &blurRect)
+{
+    const int offset = alphaOffset(image);
     const int width = blurRect.width();
     const int height = blurRect.height();
     const int rowStride = image.bytesPerLine();
@@ -197,7 +429,7 @@ static inline void boxBlurAlpha(QImage &image, int radius, const QRect &rect = {
 
     // Blur the image in horizontal direction.
     for (int i = 0; i < height; ++i) {
-        uint8_t *row = image.scanLine(blurRect.y() + i) + blurRect.x() * pixelStride + alphaOffset;
+        uint8_t *row = image.scanLine(blurRect.y() + i) + blurRect.x() * pixelStride + offset;
         boxBlurRowAlpha(row, buf1, width, pixelStride, rowStride, lobes[0], false, false);
         boxBlurRowAlpha(buf1, buf2, width, pixelStride, rowStride, lobes[1], false, false);
         boxBlurRowAlpha(buf2, row, width, pixelStride, rowStride, lobes[2], false, false);
@@ -205,13 +437,92 @@ static inline void boxBlurAlpha(QImage &image, int radius, const QRect &rect = {
 
     // Blur the image in vertical direction.
     for (int i = 0; i < width; ++i) {
-        uint8_t *column = image.scanLine(blurRect.y()) + (blurRect.x() + i) * pixelStride + alphaOffset;
+        uint8_t *column = image.scanLine(blurRect.y()) + (blurRect.x() + i) * pixelStride + offset;
         boxBlurRowAlpha(column, buf1, height, pixelStride, rowStride, lobes[0], true, false);
         boxBlurRowAlpha(buf1, buf2, height, pixelStride, rowStride, lobes[1], false, false);
         boxBlurRowAlpha(buf2, column, height, pixelStride, rowStride, lobes[2], false, true);
     }
 }
 
+/**
+ * Blur the alpha channel of a given image.
+ *
+ * The alpha channel is copied into a tightly packed 8-bit plane, so that rows
+ * are contiguous for the horizontal pass and the vertical pass can process
+ * several adjacent columns at once. The result is identical to blurring the
+ * image in place.
+ *
+ * @param image The input image.
+ * @param radius The blur radius.
+ * @param rect Specifies what part of the image to blur. If nothing is provided, then
+ *    the whole alpha channel of the input image will be blurred.
+ **/
+static inline void boxBlurAlpha(QImage &image, int radius, const QRect &rect = {})
+{
+    if (radius < 2) {
+        return;
+    }
+
+    const QVector<BoxLobes> lobes = computeLobes(radius);
+
+    const QRect blurRect = rect.isNull() ? image.rect() : rect;
+
+    const int width = blurRect.width();
+    const int height = blurRect.height();
+
+    int maxBoxSize = 0;
+    for (const BoxLobes &lobe : lobes) {
+        maxBoxSize = qMax(maxBoxSize, lobe.left + 1 + lobe.right);
+    }
+
+    if (width < maxBoxSize || height < maxBoxSize) {
+        boxBlurAlphaStrided(image, lobes, blurRect);
+        return;
+    }
+
+    const int offset = alphaOffset(image);
+    const int pixelStride = image.depth() >> 3;
+
+    const int planeSize = width * height;
+    QScopedPointer<uint8_t, QScopedPointerArrayDeleter<uint8_t> > buf(new uint8_t[2 * planeSize + 2 * width]);
+    uint8_t *plane = buf.data();
+    uint8_t *scratch = plane + planeSize;
+    uint8_t *buf1 = scratch + planeSize;
+    uint8_t *buf2 = buf1 + width;
+
+    // Extract the alpha channel.
+    for (int i = 0; i < height; ++i) {
+        const uint8_t *in = image.constScanLine(blurRect.y() + i) + blurRect.x() * pixelStride + offset;
+        uint8_t *out = plane + i * width;
+        for (int j = 0; j < width; ++j, in += pixelStride) {
+            out[j] = *in;
+        }
+    }
+
+    // Blur the plane in horizontal direction.
+    for (int i = 0; i < height; ++i) {
+        uint8_t *row = plane + i * width;
+        boxBlurRowAlpha(row, buf1, width, 1, width, lobes[0], false, false);
+        boxBlurRowAlpha(buf1, buf2, width, 1, width, lobes[1], false, false);
+        boxBlurRowAlpha(buf2, row, width, 1, width, lobes[2], false, false);
+    }
+
+    // Blur the plane in vertical direction.
+    const BoxBlurColumnsFunction blurColumns = boxBlurColumnsAlpha();
+    blurColumns(plane, scratch, width, height, lobes[0]);
+    blurColumns(scratch, plane, width, height, lobes[1]);
+    blurColumns(plane, scratch, width, height, lobes[2]);
+
+    // Write the alpha channel back.
+    for (int i = 0; i < height; ++i) {
+        const uint8_t *in = scratch + i * width;
+        uint8_t *out = image.scanLine(blurRect.y() + i) + blurRect.x() * pixelStride + offset;
+        for (int j = 0; j < width; ++j, out += pixelStride) {
+            *out = in[j];
+        }
+    }
+}
+
 static inline void mirrorTopLeftQuadrant(QImage &image)
 {
     const int width = image.width();
@@ -220,11 +531,11 @@ static inline void mirrorTopLeftQuadrant(QImage &image)
     const int centerX = qCeil(width * 0.5);
     const int centerY = qCeil(height * 0.5);
 
-    const int alphaOffset = QSysInfo::ByteOrder == QSysInfo::BigEndian ? 0 : 3;
+    const int offset = alphaOffset(image);
     const int stride = image.depth() >> 3;
 
     for (int y = 0; y < centerY; ++y) {
-        uint8_t *in = image.scanLine(y) + alphaOffset;
+        uint8_t *in = image.scanLine(y) + offset;
         uint8_t *out = in + (width - 1) * stride;
 
         for (int x = 0; x < centerX; ++x, in += stride, out -= stride) {
@@ -233,8 +544,8 @@ static inline void mirrorTopLeftQuadrant(QImage &image)
     }
 
     for (int y = 0; y < centerY; ++y) {
-        const uint8_t *in = image.scanLine(y) + alphaOffset;
-        uint8_t *out = image.scanLine(width - y - 1) + alphaOffset;
+        const uint8_t *in = image.scanLine(y) + offset;
+        uint8_t *out = image.scanLine(width - y - 1) + offset;
 
         for (int x = 0; x < width; ++x, in += stride, out += stride) {
             *out = *in;
@@ -242,14 +553,125 @@ static inline void mirrorTopLeftQuadrant(QImage &image)
     }
 }
 
-static void renderShadow(QPainter *painter, const QRect &rect, qreal borderRadius, const QPoint &offset, int radius, const QColor &color)
+/**
+ * Horizontal integral of a gaussian blurred rounded box, for one row.
+ *
+ * @param x The horizontal distance to the center of the box.
+ * @param y The vertical distance to the center of the box.
+ * @param sigma The standard deviation of the gaussian.
+ * @param corner The corner radius.
+ * @param halfWidth Half the width of the box.
+ * @param halfHeight Half the height of the box.
+ **/
+static inline qreal roundedBoxShadowRow(qreal x, qreal y, qreal sigma, qreal corner, qreal halfWidth, qreal halfHeight)
+{
+    const qreal delta = qMin(halfHeight - corner - qAbs(y), qreal(0.0));
+    const qreal curved = halfWidth - corner + std::sqrt(qMax(qreal(0.0), corner * corner - delta * delta));
+    const qreal scale = M_SQRT1_2 / sigma;
+    return 0.5 * (std::erf((x + curved) * scale) - std::erf((x - curved) * scale));
+}
+
+/**
+ * Vertical integral of the gaussian, for the part of the box between a and b.
+ *
+ * @param y The vertical distance of the pixel to the center of the box.
+ * @param a The lower bound, relative to the center of the box.
+ * @param b The upper bound, relative to the center of the box.
+ * @param sigma The standard deviation of the gaussian.
+ **/
+static inline qreal gaussianIntegral(qreal y, qreal a, qreal b, qreal sigma)
+{
+    const qreal scale = M_SQRT1_2 / sigma;
+    return 0.5 * (std::erf((y - a) * scale) - std::erf((y - b) * scale));
+}
+
+/**
+ * Fill the top-left quadrant of an alpha channel with a gaussian blurred
+ * rounded box, evaluated in closed form.
+ *
+ * The box is integrated exactly along rows. Along columns, rows between the
+ * corners all have the same width, so that part is integrated exactly too,
+ * and only the corner bands are sampled, at most a quarter of a pixel or of
+ * a standard deviation apart. This stays within one alpha level of the
+ * exact gaussian for radii 2 to 8 at device pixel ratio 1 and 2, and within
+ * 8 levels of the box blur, 1 on average, see autotests/lightlyboxshadowtest.cpp.
+ *
+ * @param image The destination image, either alpha-only or ARGB32.
+ * @param box The box, in device pixels.
+ * @param corner The corner radius, in device pixels.
+ * @param sigma The standard deviation of the gaussian, in device pixels.
+ **/
+static void renderAnalyticQuadrant(QImage &image, const QRectF &box, qreal corner, qreal sigma)
+{
+    const int width = qCeil(image.width() * 0.5);
+    const int height = qCeil(image.height() * 0.5);
+
+    const int offset = alphaOffset(image);
+    const int stride = image.depth() >> 3;
+
+    const qreal halfWidth = box.width() * 0.5;
+    const qreal halfHeight = box.height() * 0.5;
+    corner = qMin(corner, qMin(halfWidth, halfHeight));
+
+    // Without blur, the shadow is the box itself.
+    sigma = qMax(sigma, qreal(0.1));
+
+    // Corner bands, sampled at their midpoints.
+    const qreal straight = halfHeight - corner;
+    const int samples = qBound(1, qCeil(corner / qMin(qreal(0.25), sigma * 0.25)), 64);
+    const qreal step = corner / samples;
+    const qreal gaussianScale = step / (std::sqrt(2.0 * M_PI) * sigma);
+
+    struct Sample {
+        qreal y;
+        qreal weight;
+    };
+
+    QVector<Sample> bandSamples;
+    bandSamples.reserve(2 * samples);
+
+    for (int j = 0; j < height; ++j) {
+        const qreal y = j + 0.5 - box.center().y();
+
+        // straight part of the box
+        const qreal straightWeight = gaussianIntegral(y, -straight, straight, sigma);
+
+        // corner bands, skipping samples too far away to contribute
+        bandSamples.clear();
+        for (int k = 0; k < samples; ++k) {
+            const qreal band = straight + (k + 0.5) * step;
+            for (const qreal sample : {-band, band}) {
+                const qreal distance = y - sample;
+                if (qAbs(distance) > 4.0 * sigma) {
+                    continue;
+                }
+
+                bandSamples.append({sample, gaussianScale * std::exp(-(distance * distance) / (2.0 * sigma * sigma))});
+            }
+        }
+
+        uint8_t *out = image.scanLine(j) + offset;
+        for (int i = 0; i < width; ++i, out += stride) {
+            const qreal x = i + 0.5 - box.center().x();
+
+            qreal value = roundedBoxShadowRow(x, 0.0, sigma, corner, halfWidth, halfHeight) * straightWeight;
+            for (const Sample &sample : qAsConst(bandSamples)) {
+                value += roundedBoxShadowRow(x, sample.y, sigma, corner, halfWidth, halfHeight) * sample.weight;
+            }
+
+            *out = uint8_t(qBound(0, qRound(value * 255.0), 255));
+        }
+    }
+}
+
+static void renderShadow(QPainter *painter, const QRect &rect, qreal borderRadius, const QPoint &offset, int radius, const QColor &color, QImage::Format format, BoxShadowRenderer::Algorithm algorithm)
 {
     const QSize inflation = calculateBlurExtent(radius);
     const QSize size = rect.size() + 2 * inflation;
 
     const qreal dpr = painter->device()->devicePixelRatioF();
 
-    QImage shadow(size * dpr, QImage::Format_ARGB32_Premultiplied);
+    QImage shadow(size * dpr, format);
     shadow.setDevicePixelRatio(dpr);
     shadow.fill(Qt::transparent);
 
@@ -258,34 +680,55 @@ static void renderShadow(QPainter *painter, const QRect &rect, qreal borderRadiu
 
     const qreal xRadius = 2.0 * borderRadius / boxRect.width();
     const qreal yRadius = 2.0 * borderRadius / boxRect.height();
-    //qDebug() << " radius: " << radius;
-    QPainter shadowPainter;
-    shadowPainter.begin(&shadow);
-    shadowPainter.setRenderHint(QPainter::Antialiasing);
-    shadowPainter.setPen(Qt::NoPen);
-    shadowPainter.setBrush(Qt::black);
-    // For some reason, if radius is <=3, the shadow edge becomes too sharp, so we work around this. FIXME
-    //shadowPainter.drawRoundedRect(boxRect, xRadius, yRadius);
-    shadowPainter.drawRoundedRect(boxRect, radius > 3 ? xRadius : borderRadius, radius > 3 ? yRadius : borderRadius );
-    shadowPainter.end();
 
-    // Because the shadow texture is symmetrical, that's enough to blur
+    // Because the shadow texture is symmetrical, that's enough to render
     // only the top-left quadrant and then mirror it.
-    const QRect blurRect(0, 0, qCeil(shadow.width() * 0.5), qCeil(shadow.height() * 0.5));
-    const int scaledRadius = qRound(radius * dpr);
-    boxBlurAlpha(shadow, scaledRadius, blurRect);
-    mirrorTopLeftQuadrant(shadow);
+    if (algorithm == BoxShadowRenderer::Analytic) {
+        // Use the same corners as the rasterized box below.
+        const qreal corner = radius > 3 ? qMin(xRadius, yRadius) : borderRadius;
+        const QRectF scaledBoxRect(QPointF(boxRect.topLeft()) * dpr, QSizeF(boxRect.size()) * dpr);
+        const int scaledRadius = qRound(radius * dpr);
+        renderAnalyticQuadrant(shadow, scaledBoxRect, corner * dpr, calculateBoxBlurStdDev(scaledRadius));
+        mirrorTopLeftQuadrant(shadow);
+    } else {
+        //qDebug() << " radius: " << radius;
+        QPainter shadowPainter;
+        shadowPainter.begin(&shadow);
+        shadowPainter.setRenderHint(QPainter::Antialiasing);
+        shadowPainter.setPen(Qt::NoPen);
+        shadowPainter.setBrush(Qt::black);
+        // For some reason, if radius is <=3, the shadow edge becomes too sharp, so we work around this. FIXME
+        //shadowPainter.drawRoundedRect(boxRect, xRadius, yRadius);
+        shadowPainter.drawRoundedRect(boxRect, radius > 3 ? xRadius : borderRadius, radius > 3 ? yRadius : borderRadius );
+        shadowPainter.end();
+
+        const QRect blurRect(0, 0, qCeil(shadow.width() * 0.5), qCeil(shadow.height() * 0.5));
+        const int scaledRadius = qRound(radius * dpr);
+        boxBlurAlpha(shadow, scaledRadius, blurRect);
+        mirrorTopLeftQuadrant(shadow);
+    }
+
+    QRect shadowRect = shadow.rect();
+    shadowRect.setSize(shadowRect.size() / dpr);
+    shadowRect.moveCenter(rect.center() + offset);
+
+    // Alpha masks only carry the opacity of the shadow.
+    if (format == QImage::Format_Alpha8) {
+        painter->save();
+        painter->setOpacity(color.alphaF());
+        painter->drawImage(shadowRect, shadow);
+        painter->restore();
+        return;
+    }
 
     // Give the shadow a tint of the desired color.
+    QPainter shadowPainter;
     shadowPainter.begin(&shadow);
     shadowPainter.setCompositionMode(QPainter::CompositionMode_SourceIn);
     shadowPainter.fillRect(shadow.rect(), color);
     shadowPainter.end();
 
     // Actually, present the shadow.
-    QRect shadowRect = shadow.rect();
-    shadowRect.setSize(shadowRect.size() / dpr);
-    shadowRect.moveCenter(rect.center() + offset);
     painter->drawImage(shadowRect, shadow);
 }
 
@@ -294,6 +737,11 @@ void BoxShadowRenderer::setBoxSize(const QSize &size)
     m_boxSize = size;
 }
 
+void BoxShadowRenderer::setAlgorithm(Algorithm algorithm)
+{
+    m_algorithm = algorithm;
+}
+
 void BoxShadowRenderer::setBorderRadius(qreal radius)
 {
     m_borderRadius = radius;
@@ -314,6 +762,16 @@ void BoxShadowRenderer::addShadow(const QPoint &offset, int radius, const QColor
 }
 
 QImage BoxShadowRenderer::render() const
+{
+    return renderCanvas(QImage::Format_ARGB32_Premultiplied);
+}
+
+QImage BoxShadowRenderer::renderMask() const
+{
+    return renderCanvas(QImage::Format_Alpha8);
+}
+
+QImage BoxShadowRenderer::renderCanvas(QImage::Format format) const
 {
     if (m_shadows.isEmpty()) {
         return {};
@@ -325,7 +783,7 @@ QImage BoxShadowRenderer::render() const
             calculateMinimumShadowTextureSize(m_boxSize, shadow.radius, shadow.offset));
     }
 
-    QImage canvas(canvasSize * m_dpr, QImage::Format_ARGB32_Premultiplied);
+    QImage canvas(canvasSize * m_dpr, format);
     canvas.setDevicePixelRatio(m_dpr);
     canvas.fill(Qt::transparent);
 
@@ -334,13 +792,52 @@ QImage BoxShadowRenderer::render() const
 
     QPainter painter(&canvas);
     for (const Shadow &shadow : qAsConst(m_shadows)) {
-        renderShadow(&painter, boxRect, m_borderRadius, shadow.offset, shadow.radius, shadow.color);
+        renderShadow(&painter, boxRect, m_borderRadius, shadow.offset, shadow.radius, shadow.color, format, m_algorithm);
     }
     painter.end();
 
     return canvas;
 }
 
+/**
+ * Multiply all four channels of a premultiplied pixel by an alpha value.
+ **/
+static inline QRgb multiplyPixel(QRgb pixel, uint alpha)
+{
+    uint t = (pixel & 0xff00ff) * alpha;
+    t = (t + ((t >> 8) & 0xff00ff) + 0x800080) >> 8;
+    t &= 0xff00ff;
+
+    pixel = ((pixel >> 8) & 0xff00ff) * alpha;
+    pixel = (pixel + ((pixel >> 8) & 0xff00ff) + 0x800080);
+    pixel &= 0xff00ff00;
+
+    return pixel | t;
+}
+
+QImage BoxShadowRenderer::colorize(const QImage &mask, const QColor &color)
+{
+    if (mask.isNull()) {
+        return {};
+    }
+
+    const QImage alpha = mask.format() == QImage::Format_Alpha8 ? mask : mask.convertToFormat(QImage::Format_Alpha8);
+
+    QImage texture(alpha.size(), QImage::Format_ARGB32_Premultiplied);
+    texture.setDevicePixelRatio(alpha.devicePixelRatio());
+
+    const QRgb premultiplied = qPremultiply(color.rgba());
+    for (int y = 0; y < alpha.height(); ++y) {
+        const uint8_t *in = alpha.constScanLine(y);
+        QRgb *out = reinterpret_cast<QRgb *>(texture.scanLine(y));
+        for (int x = 0; x < alpha.width(); ++x) {
+            out[x] = multiplyPixel(premultiplied, in[x]);
+        }
+    }
+
+    return texture;
+}
+
 QSize BoxShadowRenderer::calculateMinimumBoxSize(int radius)
 {
     const QSize blurExtent = calculateBlurExtent(radius);
@@ -35,6 +35,30 @@ class LIGHTLYCOMMON_EXPORT BoxShadowRenderer
 public:
     // Compiler generated constructors & destructor are fine.
 
+    /**
+     * How the blurred box is generated.
+     **/
+    enum Algorithm {
+        /**
+         * Rasterize the box and approximate a gaussian blur with three box
+         * blurs. Fast for large shadows.
+         **/
+        BoxBlur,
+
+        /**
+         * Evaluate the gaussian blurred rounded box in closed form, using the
+         * error function, with the same spread as the box blur. Cheaper for
+         * small shadows, as no intermediate buffers are needed.
+         **/
+        Analytic
+    };
+
+    /**
+     * Set the algorithm used to generate the shadow.
+     * @param algorithm The algorithm, BoxBlur by default.
+     **/
+    void setAlgorithm(Algorithm algorithm);
+
     /**
      * Set the size of the box.
      * @param size The size of the box.
@@ -66,6 +90,25 @@ public:
      **/
     QImage render() const;
 
+    /**
+     * Render the shadow as an alpha mask.
+     *
+     * Only the alpha of each shadow color is taken into account, so all shadows
+     * are expected to share the same tint. The result is a Format_Alpha8 image,
+     * which takes a quarter of the memory of the texture returned by render(),
+     * and can be turned into a colored texture with colorize().
+     **/
+    QImage renderMask() const;
+
+    /**
+     * Turn an alpha mask into a colored texture.
+     *
+     * @param mask The alpha mask, as returned by renderMask().
+     * @param color The tint of the shadow. Its alpha multiplies the mask.
+     * @returns A Format_ARGB32_Premultiplied image with the device pixel ratio of the mask.
+     **/
+    static QImage colorize(const QImage &mask, const QColor &color);
+
     /**
      * Calculate the minimum size of the box.
      *
@@ -89,7 +132,10 @@ public:
     static QSize calculateMinimumShadowTextureSize(const QSize &boxSize, int radius, const QPoint &offset);
 
 private:
+    QImage renderCanvas(QImage::Format format) const;
+
     QSize m_boxSize;
+    Algorithm m_algorithm = BoxBlur;
     qreal m_borderRadius = 0.0;
     qreal m_dpr = 1.0;
 